@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2025 Your Name
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "blink_pattern.h"
+
+#define SLOT_MS         CONFIG_ZMK_BLUETOOTH_STATUS_SLOT_MS
+#define PROFILES        CONFIG_ZMK_BLUETOOTH_STATUS_PATTERN_PROFILES
+#define MAX_DUTY_PCT    CONFIG_ZMK_BLUETOOTH_STATUS_MAX_DUTY_PCT
+
+/* 图案长度（时隙数） */
+#define RECONNECT_LEN   64
+#define ADVERTISE_LEN   60
+#define HEARTBEAT_LEN   64
+
+/* n 个短脉冲：每 4 个时隙点亮 1 个（亮 1 灭 3） */
+#define PULSES(n)       (BIT64_MASK(4 * (n)) & 0x1111111111111111ULL)
+
+/*
+ * 三种状态各用不同的起始形状，配置序号由脉冲个数表示：
+ * - 回连：N 个短脉冲
+ * - 配对广播：快速双闪（计为第 1 个），隔一拍后再接 N-1 个短脉冲
+ * - 心跳：每周期一个 2 时隙的长脉冲（单脉冲，可交给 RTC 播放）
+ */
+#define RECONNECT_BITS(n)   PULSES(n)
+#define ADVERTISE_BITS(n)   (0x5ULL | (PULSES((n) - 1) << 6))
+#define HEARTBEAT_BITS      BIT64_MASK(2)
+
+/* 图案占空比不超过预算，保证平均 LED 电流受控 */
+#define DUTY_OK(bits, len) (100 * __builtin_popcountll(bits) <= MAX_DUTY_PCT * (len))
+
+BUILD_ASSERT(PROFILES * 4 <= RECONNECT_LEN, "Too many profile pulses for the pattern length");
+BUILD_ASSERT(PROFILES * 4 + 2 <= ADVERTISE_LEN, "Too many profile pulses for the pattern length");
+BUILD_ASSERT(DUTY_OK(RECONNECT_BITS(PROFILES), RECONNECT_LEN),
+             "Reconnect pattern exceeds ZMK_BLUETOOTH_STATUS_MAX_DUTY_PCT");
+BUILD_ASSERT(DUTY_OK(ADVERTISE_BITS(PROFILES), ADVERTISE_LEN),
+             "Advertising pattern exceeds ZMK_BLUETOOTH_STATUS_MAX_DUTY_PCT");
+BUILD_ASSERT(DUTY_OK(HEARTBEAT_BITS, HEARTBEAT_LEN),
+             "Heartbeat pattern exceeds ZMK_BLUETOOTH_STATUS_MAX_DUTY_PCT");
+
+/*
+ * 任意两个图案都不相同：同一状态内脉冲个数随配置递增，不同状态之间
+ * 前 3 个时隙（起始形状）互不相同，且与配置序号无关
+ */
+#define LEAD(bits)          ((bits) & BIT64_MASK(3))
+BUILD_ASSERT(LEAD(RECONNECT_BITS(1)) == LEAD(RECONNECT_BITS(PROFILES)) &&
+             LEAD(ADVERTISE_BITS(1)) == LEAD(ADVERTISE_BITS(PROFILES)),
+             "Lead-in shape must not depend on the profile");
+BUILD_ASSERT(LEAD(RECONNECT_BITS(1)) != LEAD(ADVERTISE_BITS(1)) &&
+             LEAD(RECONNECT_BITS(1)) != LEAD(HEARTBEAT_BITS) &&
+             LEAD(ADVERTISE_BITS(1)) != LEAD(HEARTBEAT_BITS),
+             "Blink modes must start with distinct shapes");
+
+#define RECONNECT_ENTRY(i, _) { .bits = RECONNECT_BITS((i) + 1), .len = RECONNECT_LEN }
+#define ADVERTISE_ENTRY(i, _) { .bits = ADVERTISE_BITS((i) + 1), .len = ADVERTISE_LEN }
+
+static const struct blink_pattern reconnect_patterns[] = {
+    LISTIFY(PROFILES, RECONNECT_ENTRY, (,))
+};
+
+static const struct blink_pattern advertise_patterns[] = {
+    LISTIFY(PROFILES, ADVERTISE_ENTRY, (,))
+};
+
+#if IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_HEARTBEAT)
+static const struct blink_pattern heartbeat_pattern = {
+    .bits = HEARTBEAT_BITS,
+    .len = HEARTBEAT_LEN,
+};
+#endif
+
+const struct blink_pattern *blink_pattern_get(enum blink_mode mode, uint8_t profile)
+{
+    /* 超出图案数量的配置使用最后一个图案 */
+    profile = MIN(profile, PROFILES - 1);
+
+    switch (mode) {
+    case BLINK_MODE_RECONNECTING:
+        return &reconnect_patterns[profile];
+    case BLINK_MODE_ADVERTISING:
+        return &advertise_patterns[profile];
+    case BLINK_MODE_CONNECTED:
+    default:
+#if IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_HEARTBEAT)
+        return &heartbeat_pattern;
+#else
+        return NULL;
+#endif
+    }
+}
+
+static uint8_t slot_at(const struct blink_pattern *pattern, uint32_t elapsed_ms)
+{
+    return (elapsed_ms / SLOT_MS) % pattern->len;
+}
+
+bool blink_pattern_level(const struct blink_pattern *pattern, uint32_t elapsed_ms)
+{
+    return (pattern->bits >> slot_at(pattern, elapsed_ms)) & 1;
+}
+
+uint32_t blink_pattern_next_edge(const struct blink_pattern *pattern, uint32_t elapsed_ms)
+{
+    uint8_t slot = slot_at(pattern, elapsed_ms);
+    bool level = (pattern->bits >> slot) & 1;
+    uint32_t ms = SLOT_MS - (elapsed_ms % SLOT_MS);
+
+    /* 跳过电平相同的时隙，空闲期间只在边沿唤醒 */
+    for (uint8_t i = 1; i < pattern->len; i++) {
+        uint8_t next = (slot + i) % pattern->len;
+
+        if (((pattern->bits >> next) & 1) != level) {
+            break;
+        }
+        ms += SLOT_MS;
+    }
+
+    return ms;
+}
+
+bool blink_pattern_single_pulse(const struct blink_pattern *pattern, uint32_t *on_ms,
+                                uint32_t *period_ms)
+{
+    uint64_t bits = pattern->bits;
+
+    uint8_t on_slots = __builtin_popcountll(bits);
+
+    /* 从第 0 个时隙开始的连续一段 1，且不是常亮 */
+    if (bits == 0 || (bits & (bits + 1)) != 0 || on_slots >= pattern->len) {
+        return false;
+    }
+
+    *on_ms = on_slots * SLOT_MS;
+    *period_ms = pattern->len * SLOT_MS;
+    return true;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025 Your Name
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 状态灯显示的蓝牙状态 */
+enum blink_mode {
+    BLINK_MODE_CONNECTED = 0,   /* 已连接：熄灭或心跳 */
+    BLINK_MODE_RECONNECTING,    /* 已绑定，等待主机回连 */
+    BLINK_MODE_ADVERTISING,     /* 未绑定，广播等待配对 */
+};
+
+/*
+ * 闪烁图案：位串存放在 flash 中，第 i 位表示第 i 个时隙是否点亮，
+ * 每个时隙 CONFIG_ZMK_BLUETOOTH_STATUS_SLOT_MS，len 个时隙后循环。
+ */
+struct blink_pattern {
+    uint64_t bits;
+    uint8_t len;
+};
+
+/**
+ * @brief 查找状态和配置对应的图案
+ * @param profile 活动配置序号（第 N 个配置闪 N+1 次）
+ * @return 图案，NULL 表示熄灭
+ */
+const struct blink_pattern *blink_pattern_get(enum blink_mode mode, uint8_t profile);
+
+/**
+ * @brief 图案开始后 elapsed_ms 时的亮灭
+ */
+bool blink_pattern_level(const struct blink_pattern *pattern, uint32_t elapsed_ms);
+
+/**
+ * @brief 距下一次亮灭变化的毫秒数
+ */
+uint32_t blink_pattern_next_edge(const struct blink_pattern *pattern, uint32_t elapsed_ms);
+
+/**
+ * @brief 图案是否为每周期单个脉冲（可交给硬件播放）
+ * @param on_ms 输出点亮时间
+ * @param period_ms 输出周期
+ */
+bool blink_pattern_single_pulse(const struct blink_pattern *pattern, uint32_t *on_ms,
+                                uint32_t *period_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2025 Your Name
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * 零CPU闪烁后端：
+ *   RTC2 COMPARE[0] --PPI--> GPIOTE OUT[n]（翻转：熄灭）
+ *   RTC2 COMPARE[1] --PPI--> GPIOTE OUT[n]（翻转：点亮）
+ *                   \--fork--> RTC2 CLEAR（开始下一周期）
+ * RTC 由常开的 32.768kHz LFCLK 驱动，系统空闲时闪烁照常进行。
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/logging/log.h>
+
+#include <nrfx_gpiote.h>
+#include <nrfx_ppi.h>
+#include <hal/nrf_gpiote.h>
+#include <hal/nrf_rtc.h>
+
+#include "blink_rtc.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+/* RTC0 由蓝牙控制器使用，RTC1 是系统时钟 */
+#define BLINK_RTC       NRF_RTC2
+#define BLINK_RTC_HZ    32768U
+
+BUILD_ASSERT(!DT_NODE_HAS_STATUS(DT_NODELABEL(rtc2), okay),
+             "RTC2 is reserved for the Bluetooth status blink");
+
+static uint8_t gpiote_channel;
+static nrf_ppi_channel_t ppi_off_channel;
+static nrf_ppi_channel_t ppi_on_channel;
+static bool channels_allocated;
+static bool running;
+
+/* nRF 引脚编号：端口号 * 32 + 引脚号 */
+static uint32_t led_psel(const struct gpio_dt_spec *led)
+{
+#if DT_NODE_HAS_STATUS(DT_NODELABEL(gpio1), okay)
+    if (led->port == DEVICE_DT_GET(DT_NODELABEL(gpio1))) {
+        return 32 + led->pin;
+    }
+#endif
+    return led->pin;
+}
+
+static int allocate_channels(void)
+{
+    if (channels_allocated) {
+        return 0;
+    }
+
+    if (nrfx_gpiote_channel_alloc(&gpiote_channel) != NRFX_SUCCESS) {
+        LOG_ERR("No free GPIOTE channel for status blink");
+        return -EBUSY;
+    }
+
+    if (nrfx_ppi_channel_alloc(&ppi_off_channel) != NRFX_SUCCESS) {
+        LOG_ERR("No free PPI channel for status blink");
+        nrfx_gpiote_channel_free(gpiote_channel);
+        return -EBUSY;
+    }
+
+    if (nrfx_ppi_channel_alloc(&ppi_on_channel) != NRFX_SUCCESS) {
+        LOG_ERR("No free PPI channel for status blink");
+        nrfx_ppi_channel_free(ppi_off_channel);
+        nrfx_gpiote_channel_free(gpiote_channel);
+        return -EBUSY;
+    }
+
+    channels_allocated = true;
+    return 0;
+}
+
+int blink_rtc_start(const struct gpio_dt_spec *led, uint32_t on_ms, uint32_t period_ms)
+{
+    if (running) {
+        return 0;
+    }
+
+    uint32_t on_ticks = (on_ms * BLINK_RTC_HZ) / 1000U;
+    uint32_t period_ticks = (period_ms * BLINK_RTC_HZ) / 1000U;
+
+    if (on_ticks == 0 || on_ticks >= period_ticks || period_ticks > RTC_COUNTER_COUNTER_Msk) {
+        return -EINVAL;
+    }
+
+    int ret = allocate_channels();
+    if (ret < 0) {
+        return ret;
+    }
+
+    /* 以点亮开始，低电平有效的灯初始输出低 */
+    bool active_low = (led->dt_flags & GPIO_ACTIVE_LOW) != 0;
+    nrf_gpiote_task_configure(NRF_GPIOTE, gpiote_channel, led_psel(led),
+                              NRF_GPIOTE_POLARITY_TOGGLE,
+                              active_low ? NRF_GPIOTE_INITIAL_VALUE_LOW
+                                         : NRF_GPIOTE_INITIAL_VALUE_HIGH);
+    nrf_gpiote_task_enable(NRF_GPIOTE, gpiote_channel);
+
+    nrf_rtc_task_trigger(BLINK_RTC, NRF_RTC_TASK_STOP);
+    nrf_rtc_task_trigger(BLINK_RTC, NRF_RTC_TASK_CLEAR);
+    nrf_rtc_prescaler_set(BLINK_RTC, 0);
+    nrf_rtc_cc_set(BLINK_RTC, 0, on_ticks);
+    nrf_rtc_cc_set(BLINK_RTC, 1, period_ticks);
+    nrf_rtc_event_clear(BLINK_RTC, NRF_RTC_EVENT_COMPARE_0);
+    nrf_rtc_event_clear(BLINK_RTC, NRF_RTC_EVENT_COMPARE_1);
+    /* 只开事件路由，不开中断 */
+    nrf_rtc_event_enable(BLINK_RTC, NRF_RTC_INT_COMPARE0_MASK | NRF_RTC_INT_COMPARE1_MASK);
+
+    uint32_t toggle = nrf_gpiote_task_address_get(NRF_GPIOTE,
+                                                  nrf_gpiote_out_task_get(gpiote_channel));
+
+    nrfx_ppi_channel_assign(ppi_off_channel,
+                            nrf_rtc_event_address_get(BLINK_RTC, NRF_RTC_EVENT_COMPARE_0),
+                            toggle);
+    nrfx_ppi_channel_assign(ppi_on_channel,
+                            nrf_rtc_event_address_get(BLINK_RTC, NRF_RTC_EVENT_COMPARE_1),
+                            toggle);
+    nrfx_ppi_channel_fork_assign(ppi_on_channel,
+                                 nrf_rtc_task_address_get(BLINK_RTC, NRF_RTC_TASK_CLEAR));
+    nrfx_ppi_channel_enable(ppi_off_channel);
+    nrfx_ppi_channel_enable(ppi_on_channel);
+
+    nrf_rtc_task_trigger(BLINK_RTC, NRF_RTC_TASK_START);
+    running = true;
+
+    LOG_DBG("RTC blink started on pin %d", led_psel(led));
+    return 0;
+}
+
+void blink_rtc_stop(void)
+{
+    if (!running) {
+        return;
+    }
+
+    nrf_rtc_task_trigger(BLINK_RTC, NRF_RTC_TASK_STOP);
+    nrfx_ppi_channel_disable(ppi_off_channel);
+    nrfx_ppi_channel_disable(ppi_on_channel);
+    nrf_rtc_event_disable(BLINK_RTC, NRF_RTC_INT_COMPARE0_MASK | NRF_RTC_INT_COMPARE1_MASK);
+    /* 关闭任务后引脚恢复为 GPIO OUT 寄存器的电平 */
+    nrf_gpiote_task_disable(NRF_GPIOTE, gpiote_channel);
+    running = false;
+
+    LOG_DBG("RTC blink stopped");
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2025 Your Name
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/drivers/gpio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 由 RTC2 比较事件经 PPI 触发 GPIOTE 翻转引脚，闪烁期间 CPU 无需唤醒
+ * @param led 状态灯引脚（每个周期以点亮开始）
+ * @param on_ms 每个周期点亮的时间
+ * @param period_ms 周期
+ * @return 0 成功，-EBUSY 无可用 GPIOTE/PPI 通道，-EINVAL 参数无效
+ */
+int blink_rtc_start(const struct gpio_dt_spec *led, uint32_t on_ms, uint32_t period_ms);
+
+/**
+ * @brief 停止硬件闪烁，引脚交还 GPIO 驱动控制
+ */
+void blink_rtc_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,35 +8,139 @@
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/devicetree.h>
+#include <zephyr/bluetooth/conn.h>
 
 #include <zmk/ble.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/ble_active_profile_changed.h>
 
+#include "paging_workqueue.h"
+
+#if IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR)
+#include "led_compositor.h"
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_BLINK_RTC)
+#include "blink_rtc.h"
+#endif
+
+#include "blink_pattern.h"
+#include "bluetooth_status.h"
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 /* 检查设备树节点是否存在 */
 #define BLUETOOTH_STATUS_NODE DT_PATH(bluetooth_status)
 
-#if DT_NODE_EXISTS(BLUETOOTH_STATUS_NODE)
+/* 状态灯输出：启用合成器时经合成器的 bt-gpios，否则使用 bluetooth_status 节点的引脚；
+ * 两者都没有时只维护连接状态缓存，供其他模块查询 */
+#if IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR)
+#define BT_STATUS_LED_COMPOSITOR 1
+#elif DT_NODE_EXISTS(BLUETOOTH_STATUS_NODE)
+#define BT_STATUS_LED_GPIO 1
+#endif
 
 /* 从设备树获取配置 */
+#if defined(BT_STATUS_LED_GPIO)
 static const struct gpio_dt_spec bluetooth_led = GPIO_DT_SPEC_GET(BLUETOOTH_STATUS_NODE, gpios);
+#endif
 
 /* 定义全局定时器 */
+#if defined(BT_STATUS_LED_GPIO)
 static struct k_timer blink_timer;
-static struct k_timer safety_timer;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_CONSISTENCY_CHECK)
+static struct k_timer check_timer;
+static struct k_work check_work;
+#endif
+static struct k_work sync_work;
+static struct k_work_delayable init_work;
 
 /* 私有数据结构 */
 struct bluetooth_status_data {
     bool led_state;
     bool is_connected;
-    bool blink_timer_running;
+    bool is_open;               /* 活动配置未绑定：广播等待配对，否则为等待回连 */
+    bool hw_blink;              /* 图案正由 RTC 硬件播放 */
+    bool ready;                 /* 延迟初始化完成前忽略事件 */
+    uint8_t profile;            /* 活动配置序号 */
+    const struct blink_pattern *pattern;    /* 当前图案，NULL 为熄灭 */
+    uint32_t pattern_start;
     uint32_t last_activity_time;
 };
 
 static struct bluetooth_status_data bluetooth_data;
 
+#if defined(BT_STATUS_LED_COMPOSITOR)
+/* 启用合成器时状态灯由合成器的 BT 输出驱动，只在图案边沿重新合成 */
+static void blink_layer_render(struct led_comp_layer *layer, uint32_t now_ms,
+                               struct led_rgb *px)
+{
+    ARG_UNUSED(layer);
+
+    bool on = blink_pattern_level(bluetooth_data.pattern, now_ms - bluetooth_data.pattern_start);
+    uint8_t level = on ? 255 : 0;
+    px[0] = (struct led_rgb){ .r = level, .g = level, .b = level };
+}
+
+static uint32_t blink_layer_next_change(struct led_comp_layer *layer, uint32_t now_ms)
+{
+    ARG_UNUSED(layer);
+    return blink_pattern_next_edge(bluetooth_data.pattern, now_ms - bluetooth_data.pattern_start);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_BLINK_RTC)
+/* 单脉冲图案位于最上层时交给 RTC+PPI+GPIOTE 播放，合成器停止渲染 */
+static int blink_layer_hw_start(struct led_comp_layer *layer)
+{
+    const struct gpio_dt_spec *led = led_comp_output_gpio(layer->output);
+    uint32_t on_ms, period_ms;
+
+    if (led == NULL) {
+        return -ENODEV;
+    }
+
+    if (!blink_pattern_single_pulse(bluetooth_data.pattern, &on_ms, &period_ms)) {
+        return -ENOTSUP;
+    }
+
+    return blink_rtc_start(led, on_ms, period_ms);
+}
+
+static void blink_layer_hw_stop(struct led_comp_layer *layer)
+{
+    ARG_UNUSED(layer);
+    blink_rtc_stop();
+}
+#endif
+
+static struct led_comp_layer blink_layer = {
+    .output = LED_COMP_OUTPUT_BT,
+    .priority = LED_COMP_PRIO_BT,
+    .count = 1,
+    .animated = true,
+    .render = blink_layer_render,
+    .next_change = blink_layer_next_change,
+#if IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_BLINK_RTC)
+    .hw_start = blink_layer_hw_start,
+    .hw_stop = blink_layer_hw_stop,
+#endif
+};
+
+static void pattern_start(void)
+{
+    /* 合成器未配置 bt-gpios 时没有可显示的输出 */
+    if (led_comp_output_size(LED_COMP_OUTPUT_BT) > 0) {
+        led_comp_layer_show(&blink_layer);
+    }
+}
+
+static void pattern_stop(void)
+{
+    led_comp_layer_hide(&blink_layer);
+}
+
+#elif defined(BT_STATUS_LED_GPIO)
 /* LED控制函数 */
 static int set_led_state(bool state)
 {
@@ -50,100 +154,202 @@ static int set_led_state(bool state)
     return 0;
 }
 
-/* 停止闪烁定时器 */
-static void stop_blink_timer(void)
+/* 闪烁定时器回调：设置当前电平，并只在下一个边沿再次唤醒 */
+static void blink_timer_handler(struct k_timer *timer)
+{
+    uint32_t elapsed = k_uptime_get_32() - bluetooth_data.pattern_start;
+
+    set_led_state(blink_pattern_level(bluetooth_data.pattern, elapsed));
+    k_timer_start(timer, K_MSEC(blink_pattern_next_edge(bluetooth_data.pattern, elapsed)),
+                  K_NO_WAIT);
+}
+
+static void pattern_start(void)
 {
-    if (bluetooth_data.blink_timer_running) {
-        k_timer_stop(&blink_timer);
-        bluetooth_data.blink_timer_running = false;
-        LOG_DBG("Blink timer stopped");
+#if IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_BLINK_RTC)
+    uint32_t on_ms, period_ms;
+
+    /* 单脉冲图案优先由硬件翻转引脚，通道不足时退回 k_timer */
+    if (blink_pattern_single_pulse(bluetooth_data.pattern, &on_ms, &period_ms) &&
+        blink_rtc_start(&bluetooth_led, on_ms, period_ms) == 0) {
+        bluetooth_data.hw_blink = true;
+        LOG_DBG("Blink pattern running on RTC");
+        return;
     }
+#endif
+    k_timer_start(&blink_timer, K_NO_WAIT, K_NO_WAIT);
+    LOG_DBG("Blink pattern running on timer");
 }
 
-/* 启动闪烁定时器 */
-static void start_blink_timer(void)
+static void pattern_stop(void)
 {
-    if (!bluetooth_data.blink_timer_running) {
-        k_timer_start(&blink_timer, K_MSEC(500), K_MSEC(500));
-        bluetooth_data.blink_timer_running = true;
-        LOG_DBG("Blink timer started");
+#if IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_BLINK_RTC)
+    if (bluetooth_data.hw_blink) {
+        blink_rtc_stop();
+        bluetooth_data.hw_blink = false;
     }
+#endif
+    k_timer_stop(&blink_timer);
+    set_led_state(false);
 }
 
-/* 闪烁定时器回调 */
-static void blink_timer_handler(struct k_timer *timer)
+#else
+/* 没有状态灯 */
+static void pattern_start(void)
 {
-    ARG_UNUSED(timer);
-    
-    if (!bluetooth_data.is_connected) {
-        set_led_state(!bluetooth_data.led_state);
+}
+
+static void pattern_stop(void)
+{
+}
+#endif
+
+/* 根据连接状态和活动配置切换图案 */
+static void update_pattern(void)
+{
+    enum blink_mode mode = bluetooth_data.is_connected ? BLINK_MODE_CONNECTED
+                         : bluetooth_data.is_open     ? BLINK_MODE_ADVERTISING
+                                                      : BLINK_MODE_RECONNECTING;
+    const struct blink_pattern *pattern = blink_pattern_get(mode, bluetooth_data.profile);
+
+    if (pattern == bluetooth_data.pattern) {
+        return;
+    }
+
+    if (bluetooth_data.pattern != NULL) {
+        pattern_stop();
+    }
+
+    bluetooth_data.pattern = pattern;
+    bluetooth_data.pattern_start = k_uptime_get_32();
+
+    if (pattern != NULL) {
+        pattern_start();
     }
+
+    LOG_DBG("Blink mode %d, profile %d", mode, bluetooth_data.profile);
 }
 
-/* 安全定时器回调 - 每10分钟检查一次，防止事件丢失 */
-static void safety_timer_handler(struct k_timer *timer)
+#if IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_CONSISTENCY_CHECK)
+/* 调试用一致性检查：状态完全由事件驱动，这里只断言，不再修正 */
+static void check_timer_handler(struct k_timer *timer)
 {
     ARG_UNUSED(timer);
+
+    /* 定时器回调在中断上下文，检查放到工作队列中执行 */
+    k_work_submit_to_queue(paging_work_q(), &check_work);
+}
+
+static void check_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
     
     bool current_state = zmk_ble_active_profile_is_connected();
     
-    /* 如果状态不一致，重新同步 */
     if (current_state != bluetooth_data.is_connected) {
-        LOG_WRN("State mismatch detected! Fixing...");
-        bluetooth_data.is_connected = current_state;
-        
-        if (current_state) {
-            stop_blink_timer();
-            set_led_state(false);
-        } else {
-            set_led_state(true);
-            start_blink_timer();
-        }
+        LOG_ERR("Bluetooth status out of sync: cached %d, actual %d",
+                bluetooth_data.is_connected, current_state);
+        __ASSERT(false, "Bluetooth status missed a connection event");
     }
     
     /* 记录活动时间 */
     bluetooth_data.last_activity_time = k_uptime_get_32();
 }
+#endif /* IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_CONSISTENCY_CHECK) */
+
+/* 按当前活动配置同步状态，所有事件来源都汇总到这里 */
+static void sync_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    bool connected = zmk_ble_active_profile_is_connected();
+    bool open = zmk_ble_active_profile_is_open();
+
+    if (connected != bluetooth_data.is_connected) {
+        LOG_INF("Bluetooth %s", connected ? "connected" : "disconnected");
+        bluetooth_data.is_connected = connected;
+    }
+
+    if (open != bluetooth_data.is_open) {
+        bluetooth_data.is_open = open;
+        LOG_INF("Active profile %s", open ? "open, advertising for pairing"
+                                          : "bonded, waiting for host");
+    }
+
+    bluetooth_data.profile = zmk_ble_active_profile_index();
+    update_pattern();
+}
 
-/* 处理连接状态变化 */
-static void handle_connection_change(bool connected)
+static void request_sync(void)
 {
-    if (connected && !bluetooth_data.is_connected) {
-        /* 连接建立 */
-        LOG_INF("Bluetooth connected");
-        stop_blink_timer();
-        set_led_state(false);
-        bluetooth_data.is_connected = true;
-    } 
-    else if (!connected && bluetooth_data.is_connected) {
-        /* 连接断开 */
-        LOG_INF("Bluetooth disconnected");
-        bluetooth_data.is_connected = false;
-        set_led_state(true);
-        start_blink_timer();
+    if (bluetooth_data.ready) {
+        k_work_submit_to_queue(paging_work_q(), &sync_work);
     }
 }
 
-/* 事件监听函数 */
+/* 事件监听函数：切换/清除配置 */
 static int bluetooth_status_event_listener(const zmk_event_t *eh)
 {
     struct zmk_ble_active_profile_changed *event = as_zmk_ble_active_profile_changed(eh);
     if (event) {
-        bool connected = zmk_ble_active_profile_is_connected();
-        handle_connection_change(connected);
-        return 0;
+        request_sync();
     }
-    return 0;
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+/* 活动配置上的连接/断开不会产生配置切换事件，直接订阅连接回调。
+ * 回调运行在蓝牙接收线程，推迟到工作队列处理 */
+static void bluetooth_status_connected(struct bt_conn *conn, uint8_t err)
+{
+    ARG_UNUSED(conn);
+    ARG_UNUSED(err);
+    request_sync();
+}
+
+static void bluetooth_status_disconnected(struct bt_conn *conn, uint8_t reason)
+{
+    ARG_UNUSED(conn);
+    ARG_UNUSED(reason);
+    request_sync();
 }
 
-/* 初始化函数 */
+BT_CONN_CB_DEFINE(bluetooth_status_conn_callbacks) = {
+    .connected = bluetooth_status_connected,
+    .disconnected = bluetooth_status_disconnected,
+};
+
+/* 延迟初始化：蓝牙栈就绪后同步一次连接状态，之后由事件驱动 */
+static void init_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    /* 初始化数据 */
+    bluetooth_data.last_activity_time = k_uptime_get_32();
+    bluetooth_data.ready = true;
+    
+    /* 根据初始状态设置图案 */
+    sync_work_handler(NULL);
+
+#if defined(BT_STATUS_LED_COMPOSITOR)
+    if (led_comp_output_size(LED_COMP_OUTPUT_BT) == 0) {
+        LOG_WRN("LED compositor has no bt-gpios output, status blinks are not shown");
+    }
+#endif
+    
+#if IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_CONSISTENCY_CHECK)
+    k_timer_start(&check_timer, K_SECONDS(CONFIG_ZMK_BLUETOOTH_STATUS_CONSISTENCY_CHECK_S),
+                  K_SECONDS(CONFIG_ZMK_BLUETOOTH_STATUS_CONSISTENCY_CHECK_S));
+#endif
+    
+    LOG_INF("Bluetooth status indicator initialized with interrupt mode");
+}
+
+/* 初始化函数：只做不阻塞的硬件配置，状态同步推迟到工作队列 */
 static int bluetooth_status_init(void)
 {
     LOG_INF("Initializing Bluetooth status indicator (interrupt mode)");
     
-    /* 等待系统稳定 */
-    k_sleep(K_MSEC(1000));
-    
+#if defined(BT_STATUS_LED_GPIO)
     /* 检查设备是否就绪 */
     if (!device_is_ready(bluetooth_led.port)) {
         LOG_ERR("Bluetooth status LED device not ready");
@@ -162,42 +368,39 @@ static int bluetooth_status_init(void)
     
     /* 初始化定时器 */
     k_timer_init(&blink_timer, blink_timer_handler, NULL);
-    k_timer_init(&safety_timer, safety_timer_handler, NULL);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_BLUETOOTH_STATUS_CONSISTENCY_CHECK)
+    k_timer_init(&check_timer, check_timer_handler, NULL);
+    k_work_init(&check_work, check_work_handler);
+#endif
+    k_work_init(&sync_work, sync_work_handler);
+    k_work_init_delayable(&init_work, init_work_handler);
     
-    /* 初始化数据 */
-    bluetooth_data.is_connected = zmk_ble_active_profile_is_connected();
-    bluetooth_data.blink_timer_running = false;
     bluetooth_data.led_state = false;
-    bluetooth_data.last_activity_time = k_uptime_get_32();
-    
-    /* 根据初始状态设置 */
-    if (bluetooth_data.is_connected) {
-        LOG_INF("Initial state: Bluetooth connected, LED off");
-        set_led_state(false);
-    } else {
-        LOG_INF("Initial state: Bluetooth disconnected, LED blinking");
-        set_led_state(true);
-        start_blink_timer();
-    }
+    bluetooth_data.ready = false;
+    bluetooth_data.pattern = NULL;
     
-    /* 启动安全定时器（每10分钟检查一次） */
-    k_timer_start(&safety_timer, K_MINUTES(10), K_MINUTES(10));
+    /* 原先在此 k_sleep(1000) 等待系统稳定，会阻塞其后所有 APPLICATION 级初始化；
+     * 改为延迟工作，不再占用初始化线程 */
+    k_work_schedule_for_queue(paging_work_q(), &init_work, K_MSEC(1000));
     
-    LOG_INF("Bluetooth status indicator initialized with interrupt mode");
     return 0;
 }
 
-/* 订阅事件 */
-ZMK_LISTENER(bluetooth_status, bluetooth_status_event_listener);
-ZMK_SUBSCRIPTION(bluetooth_status, zmk_ble_active_profile_changed);
+/* ===================== 查询接口 ===================== */
+/* 读取缓存，O(1)，不调用蓝牙栈 */
+bool bluetooth_status_is_connected(void)
+{
+    return bluetooth_data.is_connected;
+}
 
-#else
-/* 如果设备树节点不存在 */
-static int bluetooth_status_init(void)
+void bluetooth_status_update(void)
 {
-    LOG_WRN("Bluetooth status node not defined in device tree");
-    return 0;
+    request_sync();
 }
-#endif /* DT_NODE_EXISTS(BLUETOOTH_STATUS_NODE) */
+
+/* 订阅事件 */
+ZMK_LISTENER(bluetooth_status, bluetooth_status_event_listener);
+ZMK_SUBSCRIPTION(bluetooth_status, zmk_ble_active_profile_changed);
 
 SYS_INIT(bluetooth_status_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
\ No newline at end of file
@@ -5,19 +5,23 @@
 
 #pragma once
 
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
  * @brief 获取当前蓝牙连接状态
- * @return true 已连接，false 未连接
+ * @note 读取由连接事件维护的缓存，开销为 O(1)，可在刷新回调中频繁调用
+ * @return true 活动配置已连接，false 未连接或尚未完成初始化
  */
 bool bluetooth_status_is_connected(void);
 
 /**
  * @brief 手动更新蓝牙状态指示
- * @note 通常不需要手动调用，系统会自动处理
+ * @note 通常不需要手动调用，系统会自动处理；
+ *       同步在工作队列中异步完成
  */
 void bluetooth_status_update(void);
 
@@ -4,6 +4,26 @@
 #include <zephyr/kernel.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+#include "isr_timing.h"
+#endif
+
+#include "paging_workqueue.h"
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_PWM_SEQUENCE)
+#include <hal/nrf_pwm.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR)
+#include "led_compositor.h"
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_MONITOR)
+#include <zmk/event_manager.h>
+#include "events/charging_state_changed.h"
+#endif
 
 /* 注册日志模块 */
 LOG_MODULE_REGISTER(charging_status, LOG_LEVEL_INF);
@@ -11,22 +31,15 @@ LOG_MODULE_REGISTER(charging_status, LOG_LEVEL_INF);
 /* ⚠ 必须定义 DT_DRV_COMPAT，对应 DTS compatible */
 #define DT_DRV_COMPAT zmk_charging_status
 
-/* 呼吸灯参数 */
-#define BREATH_STEPS        64
-#define BREATH_PERIOD_MS    20
-#define PWM_PERIOD_USEC     1000
-
-/* Gamma-like 查表，非线性亮度更自然 */
-static const uint16_t breath_lut[BREATH_STEPS] = {
-    0,2,5,9,15,22,31,42,
-    55,70,88,109,133,160,190,223,
-    259,298,340,385,433,484,538,595,
-    655,717,781,846,911,976,1000,976,
-    911,846,781,717,655,595,538,484,
-    433,385,340,298,259,223,190,160,
-    133,109,88,70,55,42,31,22,
-    15,9,5,2
-};
+/* 呼吸灯参数与查表：由 gen_breath_lut.py 按 Kconfig 在构建时生成
+ * （BREATH_STEPS、BREATH_PERIOD_MS、BREATH_LUT_SCALE、breath_lut） */
+#include "breath_lut.h"
+
+/* PWM 周期取自设备树 pwms 属性，查表亮度按周期换算为脉宽 */
+#define PWM_PERIOD_NS       DT_INST_PWMS_PERIOD(0)
+#define BREATH_PULSE_NS(v)  ((uint32_t)(((uint64_t)(v) * PWM_PERIOD_NS) / BREATH_LUT_SCALE))
+
+BUILD_ASSERT(BREATH_PERIOD_MS >= 1, "Breathing cycle too short for the step count");
 
 /* ===================== 数据结构 ===================== */
 struct charging_status_config {
@@ -36,12 +49,207 @@ struct charging_status_config {
 
 struct charging_status_data {
     struct k_work_delayable breath_work;
+#if !IS_ENABLED(CONFIG_ZMK_CHARGING_MONITOR)
     struct gpio_callback gpio_cb;
+    struct k_work edge_work;    /* 中断只锁存边沿，由此在线程上下文处理 */
+    atomic_t edge_pending;
+    uint32_t edge_ms;           /* 最近一次边沿的时间戳 */
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+    struct isr_timing isr_timing;
+#endif
+#endif
     uint8_t step;
     bool active;
     bool work_scheduled;
+    bool hw_running;            /* 硬件序列正在播放 */
+#if IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR)
+    struct led_comp_layer layer;    /* PWM 输出上的呼吸图层 */
+    uint32_t start_ms;
+#endif
 };
 
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_PWM_SEQUENCE)
+/* ===================== 硬件序列呼吸灯 ===================== */
+/*
+ * 把整条 breath_lut 装入 PWM 序列缓冲区，由 nRF PWM 外设通过 EasyDMA
+ * 自主循环播放：SEQ0/SEQ1 指向同一缓冲区，LOOPSDONE->SEQSTART0 短接实现
+ * 无限循环，每个台阶用 REFRESH 保持 BREATH_PERIOD_MS，充电期间 CPU 无需唤醒。
+ * 播放期间序列独占该 PWM 实例，停止后恢复 Zephyr PWM 驱动的寄存器配置。
+ */
+#define BREATH_PWM_REGS     ((NRF_PWM_Type *)DT_REG_ADDR(DT_INST_PWMS_CTLR(0)))
+#define BREATH_PWM_CLK_HZ   16000000U
+#define BREATH_PWM_POLARITY BIT(15)
+#define BREATH_PWM_STOP_US  1000
+
+/* EasyDMA 只能访问 RAM，序列缓冲区不能是 const */
+static nrf_pwm_values_common_t breath_seq_values[BREATH_STEPS];
+
+/* 接管前的 PWM 寄存器，停止后恢复给 Zephyr 驱动 */
+static struct {
+    uint32_t prescaler;
+    uint32_t countertop;
+    uint32_t decoder;
+    uint32_t loop;
+    uint32_t shorts;
+    uint32_t seq_ptr[2];
+    uint32_t seq_cnt[2];
+    uint32_t seq_refresh[2];
+    uint32_t seq_enddelay[2];
+} breath_pwm_saved;
+
+/* 根据周期（纳秒）选择最小分频，使 COUNTERTOP 落在 15 位范围内 */
+static int breath_seq_timebase(uint32_t period_ns, nrf_pwm_clk_t *clk, uint16_t *top)
+{
+    for (uint8_t prescaler = 0; prescaler <= NRF_PWM_CLK_125kHz; prescaler++) {
+        uint64_t counts = ((uint64_t)period_ns * (BREATH_PWM_CLK_HZ >> prescaler)) / 1000000000U;
+
+        if (counts >= 2 && counts <= PWM_COUNTERTOP_COUNTERTOP_Msk) {
+            *clk = (nrf_pwm_clk_t)prescaler;
+            *top = (uint16_t)counts;
+            return 0;
+        }
+    }
+
+    return -ENOTSUP;
+}
+
+static int breath_seq_start(const struct device *dev)
+{
+    const struct charging_status_config *cfg = dev->config;
+    struct charging_status_data *data = dev->data;
+    NRF_PWM_Type *pwm = BREATH_PWM_REGS;
+    nrf_pwm_clk_t clk;
+    uint16_t top;
+
+    if (breath_seq_timebase(PWM_PERIOD_NS, &clk, &top) < 0) {
+        return -ENOTSUP;
+    }
+
+    /* 每个台阶重复的 PWM 周期数 */
+    uint32_t refresh = ((uint64_t)BREATH_PERIOD_MS * 1000000U) / PWM_PERIOD_NS;
+    if (refresh == 0 || refresh - 1 > PWM_SEQ_REFRESH_CNT_Msk) {
+        return -ENOTSUP;
+    }
+
+    uint16_t polarity = (cfg->pwm.flags & PWM_POLARITY_INVERTED) ? 0 : BREATH_PWM_POLARITY;
+    for (int i = 0; i < BREATH_STEPS; i++) {
+        breath_seq_values[i] = (uint16_t)(((uint32_t)breath_lut[i] * top) / BREATH_LUT_SCALE) | polarity;
+    }
+
+    /* 停止当前播放并保存 Zephyr 驱动的配置 */
+    nrf_pwm_event_clear(pwm, NRF_PWM_EVENT_STOPPED);
+    nrf_pwm_task_trigger(pwm, NRF_PWM_TASK_STOP);
+
+    breath_pwm_saved.prescaler = pwm->PRESCALER;
+    breath_pwm_saved.countertop = pwm->COUNTERTOP;
+    breath_pwm_saved.decoder = pwm->DECODER;
+    breath_pwm_saved.loop = pwm->LOOP;
+    breath_pwm_saved.shorts = pwm->SHORTS;
+    for (int i = 0; i < 2; i++) {
+        breath_pwm_saved.seq_ptr[i] = pwm->SEQ[i].PTR;
+        breath_pwm_saved.seq_cnt[i] = pwm->SEQ[i].CNT;
+        breath_pwm_saved.seq_refresh[i] = pwm->SEQ[i].REFRESH;
+        breath_pwm_saved.seq_enddelay[i] = pwm->SEQ[i].ENDDELAY;
+    }
+
+    const nrf_pwm_sequence_t seq = {
+        .values.p_common = breath_seq_values,
+        .length = BREATH_STEPS,
+        .repeats = refresh - 1,
+        .end_delay = 0,
+    };
+
+    nrf_pwm_configure(pwm, clk, NRF_PWM_MODE_UP, top);
+    nrf_pwm_decoder_set(pwm, NRF_PWM_LOAD_COMMON, NRF_PWM_STEP_AUTO);
+    nrf_pwm_sequence_set(pwm, 0, &seq);
+    nrf_pwm_sequence_set(pwm, 1, &seq);
+    nrf_pwm_loop_set(pwm, 1);
+    nrf_pwm_shorts_set(pwm, NRF_PWM_SHORT_LOOPSDONE_SEQSTART0_MASK);
+    nrf_pwm_enable(pwm);
+    nrf_pwm_task_trigger(pwm, NRF_PWM_TASK_SEQSTART0);
+
+    data->hw_running = true;
+    LOG_INF("Breath LED running from PWM sequence (top %u, refresh %u)", top, refresh);
+
+    return 0;
+}
+
+static void breath_seq_stop(const struct device *dev)
+{
+    struct charging_status_data *data = dev->data;
+    NRF_PWM_Type *pwm = BREATH_PWM_REGS;
+
+    nrf_pwm_shorts_set(pwm, 0);
+    nrf_pwm_event_clear(pwm, NRF_PWM_EVENT_STOPPED);
+    nrf_pwm_task_trigger(pwm, NRF_PWM_TASK_STOP);
+
+    /* STOP 在当前 PWM 周期结束时生效 */
+    WAIT_FOR(nrf_pwm_event_check(pwm, NRF_PWM_EVENT_STOPPED), BREATH_PWM_STOP_US, NULL);
+
+    pwm->PRESCALER = breath_pwm_saved.prescaler;
+    pwm->COUNTERTOP = breath_pwm_saved.countertop;
+    pwm->DECODER = breath_pwm_saved.decoder;
+    pwm->LOOP = breath_pwm_saved.loop;
+    pwm->SHORTS = breath_pwm_saved.shorts;
+    for (int i = 0; i < 2; i++) {
+        pwm->SEQ[i].PTR = breath_pwm_saved.seq_ptr[i];
+        pwm->SEQ[i].CNT = breath_pwm_saved.seq_cnt[i];
+        pwm->SEQ[i].REFRESH = breath_pwm_saved.seq_refresh[i];
+        pwm->SEQ[i].ENDDELAY = breath_pwm_saved.seq_enddelay[i];
+    }
+
+    data->hw_running = false;
+    LOG_DBG("PWM sequence stopped");
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_PWM_SEQUENCE) */
+
+#if IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR)
+/* ===================== 合成器图层 ===================== */
+/* PWM 通道归 LED 合成器所有，这里只按帧给出亮度，
+ * 呼吸图层位于最上层时由硬件序列接管（如启用） */
+static void breath_layer_render(struct led_comp_layer *layer, uint32_t now_ms,
+                                struct led_rgb *px)
+{
+    struct charging_status_data *data =
+        CONTAINER_OF(layer, struct charging_status_data, layer);
+
+    uint32_t step = ((now_ms - data->start_ms) / BREATH_PERIOD_MS) % BREATH_STEPS;
+    uint8_t level = (uint8_t)(((uint32_t)breath_lut[step] * 255U) / BREATH_LUT_SCALE);
+
+    px[0] = (struct led_rgb){ .r = level, .g = level, .b = level };
+}
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_PWM_SEQUENCE)
+static int breath_layer_hw_start(struct led_comp_layer *layer)
+{
+    ARG_UNUSED(layer);
+    return breath_seq_start(DEVICE_DT_INST_GET(0));
+}
+
+static void breath_layer_hw_stop(struct led_comp_layer *layer)
+{
+    ARG_UNUSED(layer);
+    breath_seq_stop(DEVICE_DT_INST_GET(0));
+}
+#endif
+
+#else
+/* 关闭呼吸灯：先停止硬件序列（如在播放），再交还 PWM 驱动输出 0 */
+static void breath_led_off(const struct device *dev)
+{
+    const struct charging_status_config *cfg = dev->config;
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_PWM_SEQUENCE)
+    struct charging_status_data *data = dev->data;
+
+    if (data->hw_running) {
+        breath_seq_stop(dev);
+    }
+#endif
+
+    pwm_set_dt(&cfg->pwm, PWM_PERIOD_NS, 0);
+}
+
 /* ===================== 呼吸灯 Handler ===================== */
 static void breath_work_handler(struct k_work *work)
 {
@@ -54,7 +262,9 @@ static void breath_work_handler(struct k_work *work)
     const struct device *dev = DEVICE_DT_INST_GET(0);
     const struct charging_status_config *cfg = dev->config;
 
+#if !IS_ENABLED(CONFIG_ZMK_CHARGING_MONITOR)
     // 每次执行前都读取GPIO状态，确保状态同步
+    // （使用充电监控器时状态由事件推送，无需重复读取引脚）
     int pin_state = gpio_pin_get_dt(&cfg->charge_gpio);
     bool is_charging = (pin_state > 0);
     
@@ -67,16 +277,26 @@ static void breath_work_handler(struct k_work *work)
             data->step = 0;
         }
     }
+#endif
 
     if (!data->active) {
         // 关闭PWM
-        pwm_set_dt(&cfg->pwm, PWM_PERIOD_USEC, 0);
+        breath_led_off(dev);
         data->work_scheduled = false;
         LOG_DBG("Breath LED off");
         return;
     } else {
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_PWM_SEQUENCE)
+        // 优先交给PWM外设自主播放，之后不再调度软件步进
+        if (data->hw_running || breath_seq_start(dev) == 0) {
+            data->work_scheduled = false;
+            return;
+        }
+        LOG_WRN("PWM sequence unavailable, using software breathing");
+#endif
+
         // 设置呼吸灯效果
-        int ret = pwm_set_dt(&cfg->pwm, PWM_PERIOD_USEC, breath_lut[data->step]);
+        int ret = pwm_set_dt(&cfg->pwm, PWM_PERIOD_NS, BREATH_PULSE_NS(breath_lut[data->step]));
         if (ret < 0) {
             LOG_WRN("Failed to set PWM: %d", ret);
             data->active = false;
@@ -90,22 +310,88 @@ static void breath_work_handler(struct k_work *work)
         // 只有在充电状态时才继续调度
         if (data->active) {
             data->work_scheduled = true;
-            k_work_schedule(&data->breath_work, K_MSEC(BREATH_PERIOD_MS));
+            k_work_schedule_for_queue(paging_work_q(), &data->breath_work,
+                                      K_MSEC(BREATH_PERIOD_MS));
         } else {
             data->work_scheduled = false;
         }
     }
 }
+#endif /* IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR) */
 
-/* ===================== GPIO 中断 Handler ===================== */
-static void charge_gpio_isr(const struct device *port,
-                            struct gpio_callback *cb,
-                            uint32_t pins)
+/* ===================== 启停呼吸 ===================== */
+/* 启用合成器时提交/撤下图层，否则由 breath_work 直接驱动 PWM */
+static void breath_start(const struct device *dev)
 {
-    struct charging_status_data *data =
-        CONTAINER_OF(cb, struct charging_status_data, gpio_cb);
+    struct charging_status_data *data = dev->data;
+
+    data->active = true;
+    data->step = 0;
+#if IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR)
+    data->start_ms = k_uptime_get_32();
+    led_comp_layer_show(&data->layer);
+#else
+    data->work_scheduled = true;
+    k_work_reschedule_for_queue(paging_work_q(), &data->breath_work, K_NO_WAIT);
+#endif
+}
+
+static void breath_stop(const struct device *dev)
+{
+    struct charging_status_data *data = dev->data;
+
+    data->active = false;
+#if IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR)
+    led_comp_layer_hide(&data->layer);
+#else
+    // 取消未执行的工作并立即关闭PWM
+    k_work_cancel_delayable(&data->breath_work);
+    breath_led_off(dev);
+    data->work_scheduled = false;
+#endif
+}
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_MONITOR)
+/* ===================== 充电状态事件监听 ===================== */
+/* 与其他监听者共用充电监控器的同一次事件分发，不再单独占用GPIO中断 */
+static int charging_status_event_listener(const zmk_event_t *eh)
+{
+    const struct zmk_charging_state_changed *ev = as_zmk_charging_state_changed(eh);
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
 
     const struct device *dev = DEVICE_DT_INST_GET(0);
+    struct charging_status_data *data = dev->data;
+
+    if (ev->state == CHARGING_STATE_FAULT) {
+        LOG_WRN("Charger fault, keeping breath LED unchanged");
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    /* DISCHARGING（拔线）和FULL都立即关闭呼吸灯 */
+    bool is_charging = (ev->state == CHARGING_STATE_CHARGING);
+
+    if (is_charging && !data->active) {
+        breath_start(dev);
+        LOG_INF("Charging detected, starting breath LED");
+    } else if (!is_charging && data->active) {
+        breath_stop(dev);
+        LOG_INF("Charging stopped, turning off LED");
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(charging_status, charging_status_event_listener);
+ZMK_SUBSCRIPTION(charging_status, zmk_charging_state_changed);
+
+#else
+/* ===================== 边沿处理 ===================== */
+/* 读取引脚并启停呼吸灯；正常在线程上下文执行，计时基线模式下直接在中断内执行 */
+static void charge_edge_handle(const struct device *dev)
+{
+    struct charging_status_data *data = dev->data;
     const struct charging_status_config *cfg = dev->config;
 
     // 获取逻辑电平
@@ -114,29 +400,80 @@ static void charge_gpio_isr(const struct device *port,
     // 逻辑电平为 1 表示充电（对于 GPIO_ACTIVE_LOW 就是物理低电平）
     bool is_charging = (pin_state > 0);
     
-    LOG_DBG("GPIO ISR: pin_state=%d, active=%d", pin_state, data->active);
+    LOG_DBG("Edge at %u ms: pin_state=%d, active=%d",
+            data->edge_ms, pin_state, data->active);
 
     if (is_charging) {
         if (!data->active) {
-            data->active = true;
-            data->step = 0;
-            data->work_scheduled = true;
-            k_work_schedule(&data->breath_work, K_NO_WAIT);
+            breath_start(dev);
             LOG_INF("Charging detected, starting breath LED");
         }
     } else {
         if (data->active) {
-            data->active = false;
-            // 取消未执行的工作
-            k_work_cancel_delayable(&data->breath_work);
-            // 立即关闭PWM
-            pwm_set_dt(&cfg->pwm, PWM_PERIOD_USEC, 0);
-            data->work_scheduled = false;
+            breath_stop(dev);
             LOG_INF("Charging stopped, turning off LED");
         }
     }
 }
 
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+static void charge_isr_timing_report(struct charging_status_data *data)
+{
+    LOG_INF("Charge ISR (%s) worst case %u ns over %u edges, deferred by %u ms",
+            IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_INLINE) ? "inline" : "latch",
+            data->isr_timing.max_ns, data->isr_timing.count,
+            k_uptime_get_32() - data->edge_ms);
+}
+#endif
+
+/* ===================== GPIO 中断 Handler ===================== */
+/* 与 kscan、EC11 共用同一 GPIO 端口中断，这里只锁存边沿和时间戳，
+ * 读取引脚、PWM 和日志全部推迟到 edge_work_handler（计时基线模式除外，
+ * 但计时报告始终在 edge_work_handler 中输出） */
+static void charge_gpio_isr(const struct device *port,
+                            struct gpio_callback *cb,
+                            uint32_t pins)
+{
+    struct charging_status_data *data =
+        CONTAINER_OF(cb, struct charging_status_data, gpio_cb);
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+    timing_t start = isr_timing_begin();
+#endif
+
+    data->edge_ms = k_uptime_get_32();
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_INLINE)
+    /* 计时基线：按原实现在中断内完成全部处理 */
+    charge_edge_handle(DEVICE_DT_INST_GET(0));
+#endif
+    atomic_set(&data->edge_pending, 1);
+    k_work_submit_to_queue(paging_work_q(), &data->edge_work);
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+    isr_timing_end(&data->isr_timing, start);
+#endif
+}
+
+/* ===================== 边沿处理（线程上下文） ===================== */
+static void edge_work_handler(struct k_work *work)
+{
+    struct charging_status_data *data =
+        CONTAINER_OF(work, struct charging_status_data, edge_work);
+
+    if (!atomic_cas(&data->edge_pending, 1, 0)) {
+        return;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+    charge_isr_timing_report(data);
+#endif
+
+#if !IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_INLINE)
+    charge_edge_handle(DEVICE_DT_INST_GET(0));
+#endif
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_CHARGING_MONITOR) */
+
 /* ===================== 初始化 ===================== */
 static int charging_status_init(const struct device *dev)
 {
@@ -148,6 +485,34 @@ static int charging_status_init(const struct device *dev)
         return -ENODEV;
     }
 
+    data->active = false;
+    data->step = 0;
+    data->work_scheduled = false;
+
+#if IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR)
+    /* PWM 输出由合成器初始化和驱动 */
+    data->layer = (struct led_comp_layer){
+        .output = LED_COMP_OUTPUT_PWM,
+        .priority = LED_COMP_PRIO_CHARGING,
+        .count = 1,
+        .animated = true,
+        .render = breath_layer_render,
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_PWM_SEQUENCE)
+        .hw_start = breath_layer_hw_start,
+        .hw_stop = breath_layer_hw_stop,
+#endif
+    };
+#else
+    /* 初始化工作队列 */
+    k_work_init_delayable(&data->breath_work, breath_work_handler);
+
+    /* 确保PWM初始状态为关闭 */
+    pwm_set_dt(&cfg->pwm, PWM_PERIOD_NS, 0);
+#endif
+
+#if !IS_ENABLED(CONFIG_ZMK_CHARGING_MONITOR)
+    /* 未启用充电监控器时自行检测CHRG引脚；
+     * 启用时由 zmk_charging_state_changed 事件驱动，初始状态随首个事件到达 */
     if (!gpio_is_ready_dt(&cfg->charge_gpio)) {
         LOG_ERR("GPIO device not ready");
         return -ENODEV;
@@ -168,6 +533,13 @@ static int charging_status_init(const struct device *dev)
         return ret;
     }
 
+    k_work_init(&data->edge_work, edge_work_handler);
+    atomic_clear(&data->edge_pending);
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+    isr_timing_setup();
+#endif
+
     gpio_init_callback(&data->gpio_cb,
                        charge_gpio_isr,
                        BIT(cfg->charge_gpio.pin));
@@ -178,18 +550,15 @@ static int charging_status_init(const struct device *dev)
         return ret;
     }
 
-    /* 初始化工作队列 */
-    k_work_init_delayable(&data->breath_work, breath_work_handler);
-
-    data->active = false;
-    data->step = 0;
-    data->work_scheduled = false;
-
-    /* 确保PWM初始状态为关闭 */
-    pwm_set_dt(&cfg->pwm, PWM_PERIOD_USEC, 0);
-    
+#if IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR)
+    /* 按当前引脚状态同步一次 */
+    atomic_set(&data->edge_pending, 1);
+    k_work_submit_to_queue(paging_work_q(), &data->edge_work);
+#else
     /* 延迟启动工作队列，避免在系统初始化关键期执行 */
-    k_work_schedule(&data->breath_work, K_MSEC(500));
+    k_work_schedule_for_queue(paging_work_q(), &data->breath_work, K_MSEC(500));
+#endif
+#endif
 
     LOG_INF("Charging status driver initialized");
 
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""
+生成充电呼吸灯查找表头文件。
+
+由 CMake 在构建时调用，参数来自 Kconfig，输出一个尺寸恰好为
+steps 的 const 表，运行时无需任何浮点运算。表中亮度以 LUT_SCALE 为满量程，
+PWM 周期取自设备树，由驱动在编译期换算为脉宽。
+"""
+
+import argparse
+import math
+
+LUT_SCALE = 10000
+
+
+def waveform(name, x):
+    """一个周期内的归一化亮度，x ∈ [0, 1)，返回 [0, 1]。"""
+    tri = 1.0 - abs(2.0 * x - 1.0)
+    if name == "sine":
+        return (1.0 - math.cos(2.0 * math.pi * x)) / 2.0
+    if name == "triangle":
+        return tri
+    if name == "exponential":
+        k = 4.0
+        return (math.exp(k * tri) - 1.0) / (math.exp(k) - 1.0)
+    raise ValueError(f"unknown waveform: {name}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--output", required=True)
+    parser.add_argument("--steps", type=int, required=True)
+    parser.add_argument("--cycle-ms", type=int, required=True)
+    parser.add_argument("--peak-permille", type=int, required=True)
+    parser.add_argument("--gamma-x100", type=int, required=True)
+    parser.add_argument("--waveform", required=True,
+                        choices=["sine", "triangle", "exponential"])
+    args = parser.parse_args()
+
+    if args.steps < 2:
+        parser.error("steps must be at least 2")
+    step_ms = args.cycle_ms // args.steps
+    if step_ms < 1:
+        parser.error("cycle is shorter than one millisecond per step")
+
+    peak = LUT_SCALE * args.peak_permille // 1000
+    gamma = args.gamma_x100 / 100.0
+    values = [round(peak * waveform(args.waveform, i / args.steps) ** gamma)
+              for i in range(args.steps)]
+    rows = []
+    for i in range(0, len(values), 8):
+        rows.append("    " + ",".join(str(v) for v in values[i:i + 8]) + ",")
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write("/* 由 gen_breath_lut.py 生成，请勿手动修改 */\n")
+        f.write(f"/* waveform={args.waveform} gamma={gamma:.2f} "
+                f"peak={args.peak_permille}/1000 cycle={args.cycle_ms}ms */\n\n")
+        f.write("#pragma once\n\n")
+        f.write("#include <stdint.h>\n\n")
+        f.write(f"#define BREATH_STEPS        {args.steps}\n")
+        f.write(f"#define BREATH_PERIOD_MS    {step_ms}\n")
+        f.write(f"#define BREATH_LUT_SCALE    {LUT_SCALE}\n\n")
+        f.write("static const uint16_t breath_lut[BREATH_STEPS] = {\n")
+        f.write("\n".join(rows) + "\n")
+        f.write("};\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,50 +1,261 @@
-#include <device.h>
-#include <drivers/led.h>
-#include <zmk/events/layer_state_changed.h>
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/led.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+
 #include <zmk/event_manager.h>
-#include <devicetree.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/keymap.h>
+
+#include "paging_workqueue.h"
+
+#if IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR)
+#include "led_compositor.h"
+#endif
+
+LOG_MODULE_REGISTER(layer_status, CONFIG_ZMK_LOG_LEVEL);
+
+#define DT_DRV_COMPAT zmk_layer_status
+
+static bool led_ready;
+
+static void layer_work_handler(struct k_work *work);
+static K_WORK_DEFINE(layer_work, layer_work_handler);
 
-// 获取 DTS 中配置的层号
-#define BLUE_LAYER DT_PROP(DT_PATH(layer_colors), blue_layer)
-#define YELLOW_LAYER DT_PROP(DT_PATH(layer_colors), yellow_layer)
+#if IS_ENABLED(CONFIG_ZMK_LAYER_STATUS_LED)
+/* ===================== 独立层指示灯 ===================== */
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT) == 1,
+             "Exactly one zmk,layer-status node is supported");
 
-static const struct device *led_dev;
+/* 每层颜色表：由设备树 colors 数组（0xRRGGBB）在编译期展开，按层号直接索引 */
+#define LAYER_COLOR_ENTRY(node_id, prop, idx)                                           \
+    {                                                                                   \
+        (uint8_t)((DT_PROP_BY_IDX(node_id, prop, idx) >> 16) & 0xFF),                   \
+        (uint8_t)((DT_PROP_BY_IDX(node_id, prop, idx) >> 8) & 0xFF),                    \
+        (uint8_t)(DT_PROP_BY_IDX(node_id, prop, idx) & 0xFF),                           \
+    },
+
+static const uint8_t layer_colors[][3] = {
+    DT_INST_FOREACH_PROP_ELEM(0, colors, LAYER_COLOR_ENTRY)
+};
+
+static const uint8_t color_off[3];
+static const uint8_t *shown_color; /* 当前已写入的颜色，NULL 表示尚未写入 */
+
+#if IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR)
+/* 指示灯归合成器的 layer-led 输出所有，这里只提交层图层并在颜色变化时请求重新合成 */
+static struct led_comp_layer led_layer;
+
+static void led_layer_render(struct led_comp_layer *layer, uint32_t now_ms,
+                             struct led_rgb *px)
+{
+    ARG_UNUSED(layer);
+    ARG_UNUSED(now_ms);
+    px[0] = (struct led_rgb){ .r = shown_color[0], .g = shown_color[1], .b = shown_color[2] };
+}
+
+static void show_layer(uint8_t layer)
+{
+    const uint8_t *color = layer < ARRAY_SIZE(layer_colors) ? layer_colors[layer] : color_off;
+
+    if (memcmp(shown_color, color, 3) == 0) {
+        return;
+    }
+
+    shown_color = color;
+    led_comp_invalidate();
+}
+
+static int layer_output_init(void)
+{
+    if (led_comp_output_size(LED_COMP_OUTPUT_LAYER) == 0) {
+        LOG_ERR("LED compositor has no layer-led output");
+        return -ENODEV;
+    }
+
+    shown_color = color_off;
+    led_layer = (struct led_comp_layer){
+        .output = LED_COMP_OUTPUT_LAYER,
+        .priority = LED_COMP_PRIO_LAYER,
+        .count = 1,
+        .render = led_layer_render,
+    };
+    led_comp_layer_show(&led_layer);
+
+    LOG_INF("Layer status LED initialized on the compositor (%u layer colors)",
+            (unsigned int)ARRAY_SIZE(layer_colors));
+    return 0;
+}
+
+#else
+BUILD_ASSERT(DT_INST_NODE_HAS_PROP(0, led),
+             "zmk,layer-status needs an led phandle without the LED compositor");
+
+/* 指示灯控制器在编译期由设备树解析，不再按名称查找 */
+static const struct device *const led_dev = DEVICE_DT_GET(DT_INST_PHANDLE(0, led));
+#define LAYER_LED_INDEX DT_INST_PROP(0, led_index)
+
+static void show_layer(uint8_t layer)
+{
+    const uint8_t *color = layer < ARRAY_SIZE(layer_colors) ? layer_colors[layer] : color_off;
+    int ret;
+
+    if (shown_color && memcmp(shown_color, color, 3) == 0) {
+        return;
+    }
+
+    ret = led_set_color(led_dev, LAYER_LED_INDEX, 3, color);
+    if (ret < 0) {
+        LOG_WRN("Failed to set layer %d color: %d", layer, ret);
+        return;
+    }
+
+    shown_color = color;
+}
 
-// 设置指定颜色
-static void set_led_color(uint8_t red, uint8_t green, uint8_t blue) {
-    if (!led_dev) {
-        led_dev = device_get_binding("layer_status_led");
-        if (!led_dev) {
-            return;
+static int layer_output_init(void)
+{
+    if (!device_is_ready(led_dev)) {
+        LOG_ERR("Layer status LED not ready");
+        return -ENODEV;
+    }
+
+    LOG_INF("Layer status LED initialized (%u layer colors)",
+            (unsigned int)ARRAY_SIZE(layer_colors));
+    return 0;
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_LED_COMPOSITOR) */
+
+#elif IS_ENABLED(CONFIG_ZMK_LAYER_STATUS_STRIP)
+/* ===================== 灯链层指示 ===================== */
+/*
+ * 用轴灯灯链编码层号：层 1-9 点亮第 (layer - 1) % 3 颗灯，颜色按 (layer - 1) / 3
+ * 依次取红、绿、蓝；层 0 三颗灯全部显示白色，与指示关闭或灯链断电区分；
+ * 更高层不显示。层 1-9 的指示图层只覆盖一个像素，其余像素仍显示轴灯效果，
+ * 两者由合成器合成后在同一次灯链刷新中发出。
+ */
+#define STRIP_LEVEL     CONFIG_ZMK_LAYER_STATUS_STRIP_BRIGHTNESS
+#define STRIP_POSITIONS 3
+
+static const struct led_rgb strip_palette[] = {
+    { .r = STRIP_LEVEL },
+    { .g = STRIP_LEVEL },
+    { .b = STRIP_LEVEL },
+};
+
+static const struct led_rgb strip_base = {
+    .r = STRIP_LEVEL, .g = STRIP_LEVEL, .b = STRIP_LEVEL,
+};
+
+#define STRIP_MAX_LAYER (STRIP_POSITIONS * ARRAY_SIZE(strip_palette))
+#define STRIP_NONE      UINT8_MAX
+
+static struct led_comp_layer strip_layer;
+static uint8_t shown_layer = STRIP_NONE;  /* STRIP_NONE 表示指示图层未显示 */
+
+static void strip_layer_render(struct led_comp_layer *layer, uint32_t now_ms,
+                               struct led_rgb *px)
+{
+    ARG_UNUSED(now_ms);
+
+    if (shown_layer == 0) {
+        for (int i = 0; i < layer->count; i++) {
+            px[i] = strip_base;
         }
+        return;
+    }
+
+    px[0] = strip_palette[(shown_layer - 1) / STRIP_POSITIONS];
+}
+
+static void show_layer(uint8_t layer)
+{
+    if (layer > STRIP_MAX_LAYER) {
+        layer = STRIP_NONE;
+    }
+    if (layer == shown_layer) {
+        return;
+    }
+
+    /* 像素位置变化时需要重新挂入合成器，隐藏与显示在同一帧内合成 */
+    led_comp_layer_hide(&strip_layer);
+    shown_layer = layer;
+    if (layer == STRIP_NONE) {
+        return;
+    }
+
+    if (layer == 0) {
+        strip_layer.first = 0;
+        strip_layer.count = STRIP_POSITIONS;
+    } else {
+        strip_layer.first = (layer - 1) % STRIP_POSITIONS;
+        strip_layer.count = 1;
+    }
+    led_comp_layer_show(&strip_layer);
+}
+
+static int layer_output_init(void)
+{
+    if (led_comp_output_size(LED_COMP_OUTPUT_STRIP) < STRIP_POSITIONS) {
+        LOG_ERR("LED strip needs at least %d pixels for layer indication", STRIP_POSITIONS);
+        return -ENODEV;
     }
 
-    struct led_rgb color = { .red = red, .green = green, .blue = blue };
-    led_rgb_set(led_dev, 0, &color); // 0 表示第 1 个 LED
+    strip_layer = (struct led_comp_layer){
+        .output = LED_COMP_OUTPUT_STRIP,
+        .priority = LED_COMP_PRIO_LAYER,
+        .count = 1,
+        .render = strip_layer_render,
+    };
+
+    LOG_INF("Layer status on LED strip initialized");
+    return 0;
 }
+#endif
+
+/*
+ * 显示最高激活层。层切换可能在同一次按键中连续产生多个事件
+ * （&to 先关闭旧层再激活新层），这里统一在工作队列中按最终的层状态
+ * 更新一次；显示内容未变时不写输出。
+ */
+static void layer_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
 
-// 根据层号切换颜色
-static void update_layer_color(uint8_t layer) {
-    switch (layer) {
-        case BLUE_LAYER:
-            set_led_color(0, 0, 255);      // 蓝光
-            break;
-        case YELLOW_LAYER:
-            set_led_color(255, 255, 0);    // 黄光
-            break;
-        default:
-            set_led_color(0, 0, 0);        // 关闭
-            break;
+    if (!led_ready) {
+        return;
     }
+
+    show_layer(zmk_keymap_highest_layer_active());
 }
 
-// 事件回调
-static void layer_state_changed_listener(const zmk_event_t *eh) {
-    const struct zmk_layer_state_changed *event = as_zmk_layer_state_changed(eh);
-    if (event->state) {  // 层被激活
-        update_layer_color(event->layer);
+/* 事件回调：激活和关闭都可能改变最高层，只登记一次刷新 */
+static int layer_state_changed_listener(const zmk_event_t *eh)
+{
+    if (as_zmk_layer_state_changed(eh) == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
     }
+
+    k_work_submit_to_queue(paging_work_q(), &layer_work);
+    return ZMK_EV_EVENT_BUBBLE;
 }
 
 ZMK_LISTENER(layer_status_listener, layer_state_changed_listener);
 ZMK_SUBSCRIPTION(layer_status_listener, zmk_layer_state_changed);
+
+static int layer_status_init(void)
+{
+    int ret = layer_output_init();
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    led_ready = true;
+    k_work_submit_to_queue(paging_work_q(), &layer_work);
+    return 0;
+}
+
+SYS_INIT(layer_status_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,340 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * SSD1306 局部刷新：在控制器前保存一份页内存副本（128x32 共 512 字节），
+ * LVGL 的每次写入按页比较，只把每页中实际变化的列区间发往控制器。
+ */
+
+#define DT_DRV_COMPAT zmk_oled_shadow
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/logging/log.h>
+
+#include "oled_shadow.h"
+
+LOG_MODULE_REGISTER(oled_shadow, CONFIG_DISPLAY_LOG_LEVEL);
+
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT) == 1,
+             "Exactly one zmk,oled-shadow node is supported");
+
+#define SHADOW_DISPLAY  DT_INST_PHANDLE(0, display)
+#define SHADOW_WIDTH    DT_PROP(SHADOW_DISPLAY, width)
+#define SHADOW_HEIGHT   DT_PROP(SHADOW_DISPLAY, height)
+#define SHADOW_PAGES    (SHADOW_HEIGHT / 8)
+#define ALL_PAGES       BIT_MASK(SHADOW_PAGES)
+
+BUILD_ASSERT(SHADOW_HEIGHT % 8 == 0, "Display height must be a whole number of pages");
+BUILD_ASSERT(SHADOW_PAGES <= 8, "Stale page mask holds at most 8 pages");
+
+struct oled_shadow_data {
+    uint8_t shadow[SHADOW_PAGES][SHADOW_WIDTH]; /* 与控制器显存一致的副本 */
+    uint8_t stale_pages;        /* 副本与控制器可能不一致的页，每位一页 */
+    struct oled_shadow_stats stats;
+};
+
+static const struct device *const oled = DEVICE_DT_GET(SHADOW_DISPLAY);
+static struct oled_shadow_data shadow_data;
+static K_MUTEX_DEFINE(shadow_lock);   /* LVGL 写入与整帧恢复互斥 */
+
+/* 把一页中 [first, last] 列区间写入控制器 */
+static int flush_span(uint8_t page, uint16_t first, uint16_t last)
+{
+    uint16_t span = last - first + 1;
+    const struct display_buffer_descriptor desc = {
+        .buf_size = span,
+        .width = span,
+        .height = 8,
+        .pitch = span,
+    };
+    int ret = display_write(oled, first, page * 8, &desc, &shadow_data.shadow[page][first]);
+
+    if (ret == 0) {
+        shadow_data.stats.bytes_sent += span;
+    }
+    return ret;
+}
+
+/* 整帧写入副本内容，调用方持有 shadow_lock */
+static int flush_frame(void)
+{
+    const struct display_buffer_descriptor desc = {
+        .buf_size = sizeof(shadow_data.shadow),
+        .width = SHADOW_WIDTH,
+        .height = SHADOW_HEIGHT,
+        .pitch = SHADOW_WIDTH,
+    };
+    int ret = display_write(oled, 0, 0, &desc, shadow_data.shadow);
+
+    if (ret == 0) {
+        shadow_data.stats.bytes_sent += sizeof(shadow_data.shadow);
+        shadow_data.stale_pages = 0;
+    }
+    return ret;
+}
+
+/*
+ * 数据为 SSD1306 页格式：每字节是一列中纵向 8 个像素，按页逐行排列。
+ * 对每一页找出与副本不同的第一列和最后一列，只更新并发送这一段。
+ * 之前写入失败的页无法比较，更新副本后整页重发，成功后恢复按列比较。
+ */
+static int oled_shadow_write(const struct device *dev, const uint16_t x, const uint16_t y,
+                             const struct display_buffer_descriptor *desc, const void *buf)
+{
+    struct oled_shadow_data *data = dev->data;
+    const uint8_t *src = buf;
+    uint8_t first_page = y / 8;
+    uint8_t pages = desc->height / 8;
+    uint8_t failed = 0;         /* 本次写入后与控制器可能不一致的页 */
+    int ret = 0;
+
+    if ((y % 8) != 0 || (desc->height % 8) != 0 || desc->pitch < desc->width ||
+        x + desc->width > SHADOW_WIDTH || y + desc->height > SHADOW_HEIGHT) {
+        LOG_ERR("Unsupported area %ux%u at (%u, %u)", desc->width, desc->height, x, y);
+        return -ENOTSUP;
+    }
+
+    k_mutex_lock(&shadow_lock, K_FOREVER);
+    data->stats.writes++;
+    data->stats.bytes_requested += desc->width * pages;
+
+    for (uint8_t p = 0; p < pages; p++, src += desc->pitch) {
+        uint8_t page = first_page + p;
+        uint8_t *dst = &data->shadow[page][x];
+        int first = -1;
+        int last = -1;
+        int err;
+
+        /* 已有页写入失败后不再访问总线，其余页只更新副本并标记 */
+        if (ret < 0) {
+            memcpy(dst, src, desc->width);
+            failed |= BIT(page);
+            continue;
+        }
+
+        if (data->stale_pages & BIT(page)) {
+            memcpy(dst, src, desc->width);
+            err = flush_span(page, 0, SHADOW_WIDTH - 1);
+            if (err == 0) {
+                data->stale_pages &= ~BIT(page);
+            }
+        } else {
+            for (int c = 0; c < desc->width; c++) {
+                if (dst[c] != src[c]) {
+                    if (first < 0) {
+                        first = c;
+                    }
+                    last = c;
+                }
+            }
+
+            if (first < 0) {
+                continue;
+            }
+
+            memcpy(&dst[first], &src[first], last - first + 1);
+            err = flush_span(page, x + first, x + last);
+        }
+
+        if (err < 0) {
+            ret = err;
+            failed |= BIT(page);
+        }
+    }
+
+    if (failed) {
+        /* 副本已更新但控制器未必写入，这些页下次写入时整页重发 */
+        LOG_WRN("OLED write failed: %d, pages 0x%02x marked stale", ret, failed);
+        data->stale_pages |= failed;
+    }
+
+    k_mutex_unlock(&shadow_lock);
+
+    return ret;
+}
+
+static int oled_shadow_read(const struct device *dev, const uint16_t x, const uint16_t y,
+                            const struct display_buffer_descriptor *desc, void *buf)
+{
+    return -ENOTSUP;
+}
+
+static void *oled_shadow_get_framebuffer(const struct device *dev)
+{
+    return NULL;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_OLED_SHADOW_POWER_GATING)
+/*
+ * 空闲掉电：ZMK 进入空闲时调用 blanking_on，除关闭显示外再关闭电荷泵；
+ * 唤醒时先开电荷泵，用副本整帧恢复显存（一次 I2C 传输），最后开显示，
+ * 不需要 LVGL 重新渲染。
+ */
+#define SSD1306_CONTROL_CMD     0x00
+#define SSD1306_CHARGE_PUMP     0x8D
+#define SSD1306_CHARGE_PUMP_ON  0x14
+#define SSD1306_CHARGE_PUMP_OFF 0x10
+
+static const struct i2c_dt_spec oled_bus = I2C_DT_SPEC_GET(SHADOW_DISPLAY);
+static bool powered_down;
+
+static int set_charge_pump(bool on)
+{
+    const uint8_t cmd[] = {
+        SSD1306_CONTROL_CMD,
+        SSD1306_CHARGE_PUMP,
+        on ? SSD1306_CHARGE_PUMP_ON : SSD1306_CHARGE_PUMP_OFF,
+    };
+
+    return i2c_write_dt(&oled_bus, cmd, sizeof(cmd));
+}
+
+static int oled_shadow_blanking_on(const struct device *dev)
+{
+    int ret = display_blanking_on(oled);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    k_mutex_lock(&shadow_lock, K_FOREVER);
+    ret = set_charge_pump(false);
+    if (ret == 0) {
+        powered_down = true;
+    } else {
+        LOG_WRN("Failed to turn off OLED charge pump: %d", ret);
+    }
+    k_mutex_unlock(&shadow_lock);
+
+    return 0;
+}
+
+static int oled_shadow_blanking_off(const struct device *dev)
+{
+    int ret = 0;
+
+    k_mutex_lock(&shadow_lock, K_FOREVER);
+    if (powered_down) {
+        ret = set_charge_pump(true);
+        if (ret == 0) {
+            powered_down = false;
+            ret = flush_frame();
+        }
+        if (ret < 0) {
+            LOG_WRN("Failed to restore OLED after power down: %d", ret);
+            shadow_data.stale_pages = ALL_PAGES;
+        }
+    }
+    k_mutex_unlock(&shadow_lock);
+
+    return display_blanking_off(oled);
+}
+#else
+static int oled_shadow_blanking_on(const struct device *dev)
+{
+    return display_blanking_on(oled);
+}
+
+static int oled_shadow_blanking_off(const struct device *dev)
+{
+    return display_blanking_off(oled);
+}
+#endif
+
+static int oled_shadow_set_brightness(const struct device *dev, const uint8_t brightness)
+{
+    return display_set_brightness(oled, brightness);
+}
+
+static int oled_shadow_set_contrast(const struct device *dev, const uint8_t contrast)
+{
+    return display_set_contrast(oled, contrast);
+}
+
+static void oled_shadow_get_capabilities(const struct device *dev,
+                                         struct display_capabilities *caps)
+{
+    display_get_capabilities(oled, caps);
+}
+
+static int oled_shadow_set_pixel_format(const struct device *dev,
+                                        const enum display_pixel_format pf)
+{
+    return display_set_pixel_format(oled, pf);
+}
+
+static int oled_shadow_set_orientation(const struct device *dev,
+                                       const enum display_orientation orientation)
+{
+    return display_set_orientation(oled, orientation);
+}
+
+static const struct display_driver_api oled_shadow_api = {
+    .blanking_on = oled_shadow_blanking_on,
+    .blanking_off = oled_shadow_blanking_off,
+    .write = oled_shadow_write,
+    .read = oled_shadow_read,
+    .get_framebuffer = oled_shadow_get_framebuffer,
+    .set_brightness = oled_shadow_set_brightness,
+    .set_contrast = oled_shadow_set_contrast,
+    .get_capabilities = oled_shadow_get_capabilities,
+    .set_pixel_format = oled_shadow_set_pixel_format,
+    .set_orientation = oled_shadow_set_orientation,
+};
+
+void oled_shadow_get_stats(struct oled_shadow_stats *stats)
+{
+    *stats = shadow_data.stats;
+}
+
+int oled_shadow_restore(void)
+{
+    int ret;
+
+    k_mutex_lock(&shadow_lock, K_FOREVER);
+    ret = flush_frame();
+    k_mutex_unlock(&shadow_lock);
+
+    return ret;
+}
+
+/* 总线时钟按 Kconfig 选择，控制器不支持 1 MHz 时保持设备树中的频率 */
+static void configure_bus_speed(void)
+{
+#if IS_ENABLED(CONFIG_ZMK_OLED_SHADOW_I2C_1M)
+    const struct device *bus = DEVICE_DT_GET(DT_BUS(SHADOW_DISPLAY));
+    int ret = i2c_configure(bus, I2C_MODE_CONTROLLER | I2C_SPEED_SET(I2C_SPEED_FAST_PLUS));
+
+    if (ret < 0) {
+        LOG_WRN("1 MHz I2C not supported (%d), keeping devicetree clock", ret);
+    }
+#endif
+}
+
+static int oled_shadow_init(const struct device *dev)
+{
+    ARG_UNUSED(dev);
+
+    if (!device_is_ready(oled)) {
+        LOG_ERR("OLED controller not ready");
+        return -ENODEV;
+    }
+
+    configure_bus_speed();
+
+    /* 清屏一次，使副本（全 0）与控制器显存一致 */
+    if (flush_frame() < 0) {
+        LOG_WRN("Initial OLED clear failed, resending whole pages");
+        shadow_data.stale_pages = ALL_PAGES;
+    }
+
+    return 0;
+}
+
+/* 须在 SSD1306（DISPLAY_INIT_PRIORITY）之后、LVGL（APPLICATION）之前初始化 */
+DEVICE_DT_INST_DEFINE(0, oled_shadow_init, NULL, &shadow_data, NULL, POST_KERNEL,
+                      CONFIG_APPLICATION_INIT_PRIORITY, &oled_shadow_api);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* OLED 局部刷新统计 */
+struct oled_shadow_stats {
+    uint32_t writes;            /* LVGL 提交的写入次数 */
+    uint32_t bytes_requested;   /* LVGL 提交的数据字节数 */
+    uint32_t bytes_sent;        /* 实际发往控制器的数据字节数 */
+};
+
+/**
+ * @brief 获取局部刷新统计
+ * @param stats 输出统计数据
+ */
+void oled_shadow_get_stats(struct oled_shadow_stats *stats);
+
+/**
+ * @brief 把副本整帧（512 字节）重新写入控制器
+ * @return 0 成功，负值为 display_write 的错误码
+ */
+int oled_shadow_restore(void);
+
+#ifdef __cplusplus
+}
+#endif
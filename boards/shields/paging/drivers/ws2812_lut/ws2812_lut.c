@@ -0,0 +1,238 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * WS2812 SPI 灯链驱动：每个颜色字节按 256 项查表展开为 8 个 SPI 字节，
+ * 写入常驻的发送缓冲区；帧内容与上一帧相同时不发起 SPI 传输。
+ */
+
+#define DT_DRV_COMPAT zmk_ws2812_spi_lut
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/drivers/led_strip.h>
+#include <zephyr/dt-bindings/led/led.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(ws2812_lut, CONFIG_LED_STRIP_LOG_LEVEL);
+
+#define WS_SPI_OPER         (SPI_OP_MODE_MASTER | SPI_TRANSFER_MSB | SPI_WORD_SET(8))
+#define WS_BYTES_PER_COLOR  8
+/* 等待上一帧发送完成的上限，远大于 3 颗灯一帧的传输时间 */
+#define WS_TX_TIMEOUT_MS    50
+
+#if IS_ENABLED(CONFIG_ZMK_WS2812_LUT_ASYNC)
+#define WS_NUM_BUFS 2
+#else
+#define WS_NUM_BUFS 1
+#endif
+
+struct ws2812_lut_config {
+    struct spi_dt_spec bus;
+    const uint8_t (*lut)[WS_BYTES_PER_COLOR];
+    const uint8_t *color_map;
+    uint8_t num_colors;
+    uint16_t length;
+    size_t buf_size;            /* 展开后的像素数据加尾部复位字节 */
+    uint8_t *bufs[WS_NUM_BUFS];
+};
+
+struct ws2812_lut_data {
+    struct led_rgb *last;       /* 上次发送的像素，用于跳过未变化的帧 */
+    bool last_valid;
+    uint8_t back;               /* 下一帧写入的缓冲区 */
+#if IS_ENABLED(CONFIG_ZMK_WS2812_LUT_ASYNC)
+    struct k_sem tx_done;
+    struct spi_buf tx_buf[WS_NUM_BUFS];     /* 异步传输期间驱动仍引用，需常驻 */
+    struct spi_buf_set tx_set[WS_NUM_BUFS];
+#endif
+};
+
+static inline uint8_t ws_channel(const struct led_rgb *px, uint8_t color_id)
+{
+    switch (color_id) {
+    case LED_COLOR_ID_RED:
+        return px->r;
+    case LED_COLOR_ID_GREEN:
+        return px->g;
+    case LED_COLOR_ID_BLUE:
+        return px->b;
+    default:
+        return 0;
+    }
+}
+
+/* 按线序逐字节查表展开，每个颜色字节对应一次 8 字节拷贝 */
+static void ws_encode(const struct ws2812_lut_config *cfg, const struct led_rgb *pixels,
+                      size_t count, uint8_t *out)
+{
+    for (size_t i = 0; i < count; i++) {
+        for (uint8_t c = 0; c < cfg->num_colors; c++) {
+            memcpy(out, cfg->lut[ws_channel(&pixels[i], cfg->color_map[c])],
+                   WS_BYTES_PER_COLOR);
+            out += WS_BYTES_PER_COLOR;
+        }
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_WS2812_LUT_ASYNC)
+static void ws_tx_done(const struct device *dev, int result, void *user_data)
+{
+    struct ws2812_lut_data *data = user_data;
+
+    ARG_UNUSED(dev);
+    if (result < 0) {
+        LOG_WRN("SPI transfer failed: %d", result);
+    }
+    k_sem_give(&data->tx_done);
+}
+#endif
+
+static int ws_send(const struct device *dev, uint8_t buf)
+{
+    const struct ws2812_lut_config *cfg = dev->config;
+    struct ws2812_lut_data *data = dev->data;
+
+#if IS_ENABLED(CONFIG_ZMK_WS2812_LUT_ASYNC)
+    /* 另一块缓冲区上一帧仍可能在 DMA 中，编码已完成，这里只等待总线空闲 */
+    if (k_sem_take(&data->tx_done, K_MSEC(WS_TX_TIMEOUT_MS)) < 0) {
+        LOG_WRN("Previous frame still in flight");
+        return -EBUSY;
+    }
+
+    int ret = spi_transceive_cb(cfg->bus.bus, &cfg->bus.config, &data->tx_set[buf], NULL,
+                                ws_tx_done, data);
+    if (ret < 0) {
+        k_sem_give(&data->tx_done);
+    }
+    return ret;
+#else
+    const struct spi_buf tx_buf = { .buf = cfg->bufs[buf], .len = cfg->buf_size };
+    const struct spi_buf_set tx = { .buffers = &tx_buf, .count = 1 };
+
+    ARG_UNUSED(data);
+    return spi_write_dt(&cfg->bus, &tx);
+#endif
+}
+
+static int ws2812_lut_update_rgb(const struct device *dev, struct led_rgb *pixels,
+                                 size_t num_pixels)
+{
+    const struct ws2812_lut_config *cfg = dev->config;
+    struct ws2812_lut_data *data = dev->data;
+    size_t count = MIN(num_pixels, cfg->length);
+    uint8_t buf = data->back;
+    int ret;
+
+    if (data->last_valid && count == cfg->length &&
+        memcmp(data->last, pixels, count * sizeof(struct led_rgb)) == 0) {
+        return 0;
+    }
+
+    ws_encode(cfg, pixels, count, cfg->bufs[buf]);
+
+    ret = ws_send(dev, buf);
+    if (ret < 0) {
+        data->last_valid = false;
+        return ret;
+    }
+
+    memcpy(data->last, pixels, count * sizeof(struct led_rgb));
+    data->last_valid = (count == cfg->length);
+    data->back = (buf + 1) % WS_NUM_BUFS;
+    return 0;
+}
+
+static int ws2812_lut_update_channels(const struct device *dev, uint8_t *channels,
+                                      size_t num_channels)
+{
+    return -ENOTSUP;
+}
+
+static const struct led_strip_driver_api ws2812_lut_api = {
+    .update_rgb = ws2812_lut_update_rgb,
+    .update_channels = ws2812_lut_update_channels,
+};
+
+static int ws2812_lut_init(const struct device *dev)
+{
+    const struct ws2812_lut_config *cfg = dev->config;
+    struct ws2812_lut_data *data = dev->data;
+
+    if (!spi_is_ready_dt(&cfg->bus)) {
+        LOG_ERR("SPI bus not ready");
+        return -ENODEV;
+    }
+
+    for (uint8_t c = 0; c < cfg->num_colors; c++) {
+        switch (cfg->color_map[c]) {
+        case LED_COLOR_ID_RED:
+        case LED_COLOR_ID_GREEN:
+        case LED_COLOR_ID_BLUE:
+            break;
+        default:
+            LOG_ERR("Unsupported color channel %d", cfg->color_map[c]);
+            return -EINVAL;
+        }
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_WS2812_LUT_ASYNC)
+    k_sem_init(&data->tx_done, 1, 1);
+    for (int i = 0; i < WS_NUM_BUFS; i++) {
+        data->tx_buf[i] = (struct spi_buf){ .buf = cfg->bufs[i], .len = cfg->buf_size };
+        data->tx_set[i] = (struct spi_buf_set){ .buffers = &data->tx_buf[i], .count = 1 };
+    }
+#else
+    ARG_UNUSED(data);
+#endif
+
+    return 0;
+}
+
+/* 查表项：字节 v 的 8 位由高到低分别映射为 1/0 帧 */
+#define WS_BIT(v, b, inst)                                                              \
+    ((((v) >> (b)) & 1) ? DT_INST_PROP(inst, spi_one_frame)                             \
+                        : DT_INST_PROP(inst, spi_zero_frame))
+#define WS_LUT_ENTRY(v, inst)                                                           \
+    {                                                                                   \
+        WS_BIT(v, 7, inst), WS_BIT(v, 6, inst), WS_BIT(v, 5, inst), WS_BIT(v, 4, inst), \
+        WS_BIT(v, 3, inst), WS_BIT(v, 2, inst), WS_BIT(v, 1, inst), WS_BIT(v, 0, inst), \
+    }
+
+#define WS_NUM_COLORS(inst) DT_INST_PROP_LEN(inst, color_mapping)
+#define WS_FRAME_SIZE(inst)                                                             \
+    (DT_INST_PROP(inst, chain_length) * WS_NUM_COLORS(inst) * WS_BYTES_PER_COLOR)
+#define WS_BUF_SIZE(inst)   (WS_FRAME_SIZE(inst) + DT_INST_PROP(inst, reset_bytes))
+
+/* 复位字节位于缓冲区尾部，初始化为 0 后不再写入 */
+#define WS_BUF_DEFINE(i, inst) static uint8_t ws_buf_##inst##_##i[WS_BUF_SIZE(inst)]
+#define WS_BUF_REF(i, inst)    ws_buf_##inst##_##i
+
+#define WS2812_LUT_DEFINE(inst)                                                         \
+    BUILD_ASSERT(WS_NUM_COLORS(inst) <= 3, "Only RGB channels are supported");         \
+    static const uint8_t ws_lut_##inst[256][WS_BYTES_PER_COLOR] = {                     \
+        LISTIFY(256, WS_LUT_ENTRY, (,), inst)                                           \
+    };                                                                                  \
+    static const uint8_t ws_color_map_##inst[] = DT_INST_PROP(inst, color_mapping);    \
+    LISTIFY(WS_NUM_BUFS, WS_BUF_DEFINE, (;), inst);                                     \
+    static struct led_rgb ws_last_##inst[DT_INST_PROP(inst, chain_length)];            \
+    static const struct ws2812_lut_config ws2812_lut_config_##inst = {                  \
+        .bus = SPI_DT_SPEC_INST_GET(inst, WS_SPI_OPER, 0),                              \
+        .lut = ws_lut_##inst,                                                           \
+        .color_map = ws_color_map_##inst,                                               \
+        .num_colors = WS_NUM_COLORS(inst),                                              \
+        .length = DT_INST_PROP(inst, chain_length),                                     \
+        .buf_size = WS_BUF_SIZE(inst),                                                  \
+        .bufs = { LISTIFY(WS_NUM_BUFS, WS_BUF_REF, (,), inst) },                        \
+    };                                                                                  \
+    static struct ws2812_lut_data ws2812_lut_data_##inst = {                            \
+        .last = ws_last_##inst,                                                         \
+    };                                                                                  \
+    DEVICE_DT_INST_DEFINE(inst, ws2812_lut_init, NULL, &ws2812_lut_data_##inst,         \
+                          &ws2812_lut_config_##inst, POST_KERNEL,                       \
+                          CONFIG_LED_STRIP_INIT_PRIORITY, &ws2812_lut_api);
+
+DT_INST_FOREACH_STATUS_OKAY(WS2812_LUT_DEFINE)
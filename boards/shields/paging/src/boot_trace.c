@@ -0,0 +1,61 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/init.h>
+#include <zephyr/drivers/hwinfo.h>
+
+LOG_MODULE_REGISTER(boot_trace, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+
+// 启动耗时追踪：记录本扩展板 APPLICATION 级初始化完成的时间和首次按键的时间。
+// nRF 从 System OFF 唤醒等同于复位，每次上电或唤醒都会重新报告一次，
+// 通过复位原因区分两种情况。
+static uint32_t init_done_ms;
+static uint32_t reset_cause;
+static bool first_press_seen;
+
+static const char *boot_kind(void)
+{
+    if (reset_cause & RESET_LOW_POWER_WAKE) {
+        return "wake from System OFF";
+    }
+    // nRF52840 上电或掉电复位不在 RESETREAS 中留下任何标志，没有复位原因即视为上电
+    if (reset_cause == 0 || (reset_cause & (RESET_POR | RESET_BROWNOUT))) {
+        return "power-on";
+    }
+    return "reset";
+}
+
+static int boot_trace_listener(const zmk_event_t *eh)
+{
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+
+    if (ev == NULL || !ev->state || first_press_seen) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    first_press_seen = true;
+    LOG_INF("Boot trace (%s): init done at %u ms, first keypress at %u ms",
+            boot_kind(), init_done_ms, (uint32_t)ev->timestamp);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(boot_trace, boot_trace_listener);
+ZMK_SUBSCRIPTION(boot_trace, zmk_position_state_changed);
+
+static int boot_trace_init(void)
+{
+    if (hwinfo_get_reset_cause(&reset_cause) == 0) {
+        hwinfo_clear_reset_cause();
+    }
+
+    init_done_ms = k_uptime_get_32();
+    LOG_INF("Boot trace (%s): init done at %u ms", boot_kind(), init_done_ms);
+    return 0;
+}
+
+// 99 是 APPLICATION 级最低优先级，本扩展板只有这一项使用；
+// 其他模块同为 99 的初始化之间按链接顺序执行，不保证都在它之前
+SYS_INIT(boot_trace_init, APPLICATION, 99);
@@ -5,12 +5,16 @@
 LOG_MODULE_REGISTER(charging_backlight, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/backlight.h>
+#include <zmk/event_manager.h>
 #include "charging_monitor.h"
+#include "events/charging_state_changed.h"
+#include "paging_workqueue.h"
 
 static struct k_work_delayable init_work;
+static bool controller_ready;
 
-// 充电状态变化回调函数
-static void on_charging_state_changed(charging_state_t new_state)
+// 根据充电状态控制背光
+static void apply_charging_state(charging_state_t new_state)
 {
     switch (new_state) {
     case CHARGING_STATE_CHARGING:
@@ -23,34 +27,43 @@ static void on_charging_state_changed(charging_state_t new_state)
         zmk_backlight_off();
         break;
         
-    case CHARGING_STATE_ERROR:
+    case CHARGING_STATE_DISCHARGING:
+        LOG_INF("USB unplugged - Turning backlight OFF");
+        zmk_backlight_off();
+        break;
+        
+    case CHARGING_STATE_FAULT:
         LOG_WRN("Charging monitor error - Leaving backlight unchanged");
         break;
     }
 }
 
+// 充电状态事件监听
+static int charging_backlight_event_listener(const zmk_event_t *eh)
+{
+    const struct zmk_charging_state_changed *ev = as_zmk_charging_state_changed(eh);
+    
+    // 延迟初始化完成前忽略事件，初始化时会主动同步一次
+    if (ev && controller_ready) {
+        apply_charging_state(ev->state);
+    }
+    
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(charging_backlight, charging_backlight_event_listener);
+ZMK_SUBSCRIPTION(charging_backlight, zmk_charging_state_changed);
+
 // 延迟初始化工作函数
 static void delayed_init_work_handler(struct k_work *work)
 {
     ARG_UNUSED(work);
     
-    int ret;
-    
     LOG_INF("Initializing charging backlight controller");
     
-    // 初始化充电监控器
-    ret = charging_monitor_init();
-    if (ret != 0) {
-        LOG_ERR("Failed to initialize charging monitor: %d", ret);
-        return;
-    }
-    
-    // 注册回调到充电监控器
-    ret = charging_monitor_register_callback(on_charging_state_changed);
-    if (ret != 0) {
-        LOG_ERR("Failed to register backlight callback: %d", ret);
-        return;
-    }
+    // 同步当前状态，之后由事件驱动
+    controller_ready = true;
+    apply_charging_state(charging_monitor_get_state());
     
     LOG_INF("Charging backlight controller initialization completed");
 }
@@ -60,11 +73,11 @@ static int charging_backlight_controller_init(void)
 {
     // 延迟3秒初始化，确保键盘功能先启动
     k_work_init_delayable(&init_work, delayed_init_work_handler);
-    k_work_reschedule(&init_work, K_SECONDS(3));
+    k_work_reschedule_for_queue(paging_work_q(), &init_work, K_SECONDS(3));
     
     LOG_INF("Charging backlight controller scheduled for initialization");
     return 0;
 }
 
-// Zephyr系统初始化
-SYS_INIT(charging_backlight_controller_init, APPLICATION, 99);
\ No newline at end of file
+// Zephyr系统初始化（99 留给 boot_trace，使其排在本扩展板所有初始化之后）
+SYS_INIT(charging_backlight_controller_init, APPLICATION, 98);
\ No newline at end of file
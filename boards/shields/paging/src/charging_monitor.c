@@ -1,291 +1,509 @@
+#define DT_DRV_COMPAT zmk_charging_monitor
+
 #include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/barrier.h>
 
 LOG_MODULE_REGISTER(charging_monitor, CONFIG_ZMK_LOG_LEVEL);
 
-#include "charging_monitor.h"
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#if IS_ENABLED(CONFIG_ZMK_USB)
+#include <zmk/usb.h>
+#include <zmk/events/usb_conn_state_changed.h>
+#endif
 
-// 硬编码GPIO配置：使用P1.09 (GPIO1 pin 9)
-#define CHARGING_GPIO_PORT      DT_NODELABEL(gpio1)  // GPIO1设备
-#define CHARGING_GPIO_PIN       9                    // P1.09
-#define CHARGING_GPIO_FLAGS     (GPIO_ACTIVE_LOW | GPIO_PULL_UP)  // 低电平有效，上拉
+#include "charging_monitor.h"
+#include "events/charging_state_changed.h"
+#include "paging_workqueue.h"
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+#include "isr_timing.h"
+#endif
 
-// 轮询间隔配置（毫秒）- 直接硬编码
-#define POLL_INTERVAL_CHARGING_MS   2000   // 充电中：2秒
-#define POLL_INTERVAL_FULL_MS      10000   // 充满：10秒
-#define POLL_INTERVAL_ERROR_MS     30000   // 错误：30秒
-#define POLL_INTERVAL_INTERRUPT_MS 30000   // 中断模式下的后备轮询间隔
+// 引脚、防抖时间和轮询间隔均来自设备树，见 dts/bindings/charging-monitor.yaml
 
-// 空闲检测配置
-#define IDLE_TIMEOUT_MS           30000    // 30秒无活动视为空闲
-#define IDLE_MULTIPLIER           2        // 空闲时轮询间隔乘数
+// 错误状态退避上限（毫秒）
+#define MAX_ERROR_BACKOFF_MS      120000   // 最大2分钟
 
 // 最大连续错误次数
 #define MAX_CONSECUTIVE_ERRORS    5
 
-// 防抖时间（毫秒）
-#define DEBOUNCE_TIME_MS          1000     // 状态变化防抖时间
+// 全局API所指向的主实例：优先使用 chosen zmk,charging-monitor，否则取第0个实例
+#if DT_HAS_CHOSEN(zmk_charging_monitor)
+#define CHARGING_MONITOR_PRIMARY_NODE DT_CHOSEN(zmk_charging_monitor)
+#else
+#define CHARGING_MONITOR_PRIMARY_NODE DT_DRV_INST(0)
+#endif
 
-// 中断防抖时间（微秒）- 硬件防抖
-#define INTERRUPT_DEBOUNCE_US     50000    // 50ms中断防抖
+// 充电监控器配置（编译期由设备树生成，只读）
+struct charging_monitor_config {
+    struct gpio_dt_spec chrg_gpio;
+    struct gpio_dt_spec stdby_gpio;    // 可选，port为NULL表示未接STDBY
+    uint32_t debounce_ms;              // 状态变化防抖时间
+    uint32_t interrupt_debounce_ms;    // 中断防抖时间
+    uint32_t poll_charging_ms;         // 充电中轮询间隔
+    uint32_t poll_full_ms;             // 充满轮询间隔
+    uint32_t poll_error_ms;            // 错误状态轮询间隔
+    uint32_t poll_interrupt_ms;        // 中断模式下的后备轮询间隔
+    uint32_t idle_timeout_ms;          // 无活动视为空闲的时间
+    uint8_t idle_multiplier;           // 空闲时轮询间隔乘数
+};
 
-// 工作模式枚举
-enum work_mode {
-    MODE_POLLING = 0,     // 纯轮询模式
-    MODE_INTERRUPT,       // 中断模式（主）+轮询（后备）
-    MODE_ERROR            // 错误模式，回退到轮询
+// 对外快照的影子副本（不含中断计数，中断计数单独原子维护）
+struct charging_monitor_shadow {
+    charging_state_t state;
+    charging_monitor_mode_t mode;
+    int64_t since_ms;
 };
 
+// 快照读取重试次数：读取期间写者发布了新快照时需要重试
+#define SNAPSHOT_READ_RETRIES     4
+
 // 充电监控器私有数据结构（带中断支持）
+// 并发约定：
+// - 中断上下文只写 irq_count、irq_latched（原子）和 last_interrupt_time（仅ISR读写）
+// - 事件监听者和外部API只设置原子标志并提交检查，不直接写状态字段
+// - 其余字段只在paging工作队列（及初始化）中写入
+// - 其他线程通过双槽影子副本读取一致的快照，不关中断、不加锁
 struct charging_monitor_data {
+    const struct device *dev;
+
     // 状态变量
     charging_state_t current_state;
-    
+
     // 工作队列
     struct k_work_delayable status_check_work;
-    struct k_work callback_work;
     struct k_work interrupt_work;      // 专门处理中断的工作项
-    
+
     // GPIO相关
-    const struct device *gpio_dev;
-    struct gpio_callback gpio_cb;      // GPIO回调结构
-    
-    // 回调函数
-    charging_state_changed_cb_t callback;
-    
+    struct gpio_callback gpio_cb;      // CHRG引脚回调结构
+    struct gpio_callback stdby_cb;     // STDBY引脚回调结构
+
     // 统计和控制标志
     uint32_t consecutive_errors;
-    uint32_t interrupt_count;          // 中断计数
+    atomic_t irq_count;                // 中断计数（ISR原子递增）
+    atomic_t irq_latched;              // ISR锁存的边沿，由状态检查取走
+    atomic_t activity_latched;         // 外部锁存的键盘活动，由状态检查取走
+    atomic_t timer_poll;               // 下一次检查是否由轮询定时器触发
+    uint32_t poll_count;               // 定时轮询唤醒计数（无节拍模式下应保持为0）
     int64_t last_activity_time;
     int64_t last_state_change_time;
     int64_t last_interrupt_time;       // 上次中断时间
+    int64_t fault_seen_time;           // 首次读到故障引脚组合的时间
     bool initialized : 1;
     bool polling_active : 1;
     bool system_idle : 1;
     bool interrupt_enabled : 1;        // 中断是否启用
-    bool in_interrupt : 1;             // 是否正在处理中断
-    enum work_mode mode;               // 工作模式
+    bool report_pending : 1;           // 是否需要发布初始状态事件
+    bool fault_seen : 1;               // 最近一次读取是否为故障组合（等待确认）
+    charging_monitor_mode_t mode;      // 工作模式
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+    struct isr_timing isr_timing;      // 中断耗时统计（仅ISR写入）
+#endif
+
+    // 快照影子副本：写者写入非当前槽位后递增代数，读者按代数选择槽位
+    struct charging_monitor_shadow shadow[2];
+    atomic_t shadow_gen;
 };
 
-// 获取私有数据实例
+// 获取主实例私有数据
 static struct charging_monitor_data *get_data(void)
 {
-    static struct charging_monitor_data data = {
-        .current_state = CHARGING_STATE_ERROR,
-        .callback = NULL,
-        .gpio_dev = NULL,
-        .consecutive_errors = 0,
-        .interrupt_count = 0,
-        .last_activity_time = 0,
-        .last_state_change_time = 0,
-        .last_interrupt_time = 0,
-        .initialized = false,
-        .polling_active = true,
-        .system_idle = false,
-        .interrupt_enabled = false,
-        .in_interrupt = false,
-        .mode = MODE_POLLING,
-    };
-    return &data;
+    const struct device *dev = DEVICE_DT_GET(CHARGING_MONITOR_PRIMARY_NODE);
+    return dev->data;
 }
 
-// GPIO中断处理函数（在中断上下文中执行）
-static void gpio_interrupt_handler(const struct device *dev, 
-                                   struct gpio_callback *cb, 
-                                   uint32_t pins)
+// 记录活动时间
+static void record_activity(struct charging_monitor_data *data)
+{
+    data->last_activity_time = k_uptime_get();
+
+    // 如果从空闲状态恢复，记录日志
+    if (data->system_idle) {
+        data->system_idle = false;
+        LOG_DBG("Activity detected, exiting idle mode");
+    }
+}
+
+// 获取状态名称
+static const char *state_to_str(charging_state_t state)
+{
+    switch (state) {
+    case CHARGING_STATE_DISCHARGING:
+        return "DISCHARGING";
+    case CHARGING_STATE_CHARGING:
+        return "CHARGING";
+    case CHARGING_STATE_FULL:
+        return "FULL";
+    case CHARGING_STATE_FAULT:
+        return "FAULT";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+static int read_charger_state(struct charging_monitor_data *data, charging_state_t *state);
+
+// 充电器引脚边沿锁存（在中断上下文中执行，CHRG和STDBY共用）
+static void latch_edge(struct charging_monitor_data *data)
 {
-    struct charging_monitor_data *data = CONTAINER_OF(cb, struct charging_monitor_data, gpio_cb);
+    const struct charging_monitor_config *cfg = data->dev->config;
     int64_t now = k_uptime_get();
-    
-    // 中断防抖：避免过于频繁的中断
-    if ((now - data->last_interrupt_time) * 1000 < INTERRUPT_DEBOUNCE_US) {
-        LOG_DBG("Interrupt debounced, too frequent");
+
+    // 中断防抖：避免过于频繁的中断；被丢弃的边沿在防抖窗口结束后补做一次检查，
+    // 防止触点抖动或快速插拔后的最终状态丢失
+    int64_t elapsed = now - data->last_interrupt_time;
+
+    if (elapsed < cfg->interrupt_debounce_ms) {
+        atomic_set(&data->irq_latched, 1);
+        atomic_clear(&data->timer_poll);
+        k_work_reschedule_for_queue(paging_work_q(), &data->status_check_work,
+                                    K_MSEC(cfg->interrupt_debounce_ms - elapsed));
         return;
     }
-    
+
     data->last_interrupt_time = now;
-    data->interrupt_count++;
-    
-    // 记录活动（中断表示可能有状态变化）
-    data->last_activity_time = now;
-    
-    // 标记正在处理中断
-    data->in_interrupt = true;
-    
-    // 提交中断工作项到系统工作队列（非中断上下文）
-    k_work_submit(&data->interrupt_work);
-    
-    LOG_DBG("GPIO interrupt detected, count: %u", data->interrupt_count);
+    atomic_inc(&data->irq_count);
+
+    // 锁存边沿，由状态检查判断触发来源（活动时间在工作队列中记录）
+    atomic_set(&data->irq_latched, 1);
+
+    // 提交中断工作项到工作队列（非中断上下文）
+    k_work_submit_to_queue(paging_work_q(), &data->interrupt_work);
+}
+
+// 充电器引脚中断入口；启用计时时整个处理过程都在探针之内
+static void latch_interrupt(struct charging_monitor_data *data)
+{
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+    timing_t start = isr_timing_begin();
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_INLINE)
+    // 计时基线：按原实现在中断内读取引脚并解码状态
+    charging_state_t state;
+
+    if (read_charger_state(data, &state) == 0) {
+        LOG_DBG("GPIO ISR: charger state %s", state_to_str(state));
+    }
+#endif
+
+    latch_edge(data);
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+    isr_timing_end(&data->isr_timing, start);
+#endif
+}
+
+// CHRG引脚中断处理函数
+static void gpio_interrupt_handler(const struct device *port,
+                                   struct gpio_callback *cb,
+                                   uint32_t pins)
+{
+    latch_interrupt(CONTAINER_OF(cb, struct charging_monitor_data, gpio_cb));
+}
+
+// STDBY引脚中断处理函数
+static void stdby_interrupt_handler(const struct device *port,
+                                    struct gpio_callback *cb,
+                                    uint32_t pins)
+{
+    latch_interrupt(CONTAINER_OF(cb, struct charging_monitor_data, stdby_cb));
 }
 
-// 中断工作处理函数（在系统工作队列中执行，非中断上下文）
+// 立即执行一次非定时触发的状态检查（可在任意线程调用）
+static void request_check(struct charging_monitor_data *data)
+{
+    atomic_clear(&data->timer_poll);
+    k_work_reschedule_for_queue(paging_work_q(), &data->status_check_work, K_NO_WAIT);
+}
+
+// 中断工作处理函数（在工作队列中执行，非中断上下文）
 static void interrupt_work_handler(struct k_work *work)
 {
     struct charging_monitor_data *data = CONTAINER_OF(work, struct charging_monitor_data, interrupt_work);
-    
-    if (!data->initialized || !data->gpio_dev) {
+
+    if (!data->initialized) {
         return;
     }
-    
-    LOG_DBG("Processing interrupt work");
-    
+
+    LOG_DBG("Processing interrupt work, count: %u", (uint32_t)atomic_get(&data->irq_count));
+
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+    LOG_INF("Charge ISR (%s) worst case %u ns over %u edges",
+            IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_INLINE) ? "inline" : "latch",
+            data->isr_timing.max_ns, data->isr_timing.count);
+#endif
+
+    // 记录活动（中断表示可能有状态变化）
+    record_activity(data);
+
     // 取消可能正在排队的状态检查工作
     k_work_cancel_delayable(&data->status_check_work);
-    
+
     // 立即执行状态检查
-    k_work_reschedule(&data->status_check_work, K_NO_WAIT);
-    
-    // 清除中断标记
-    data->in_interrupt = false;
+    request_check(data);
 }
 
-// 异步回调工作函数
-static void callback_work_handler(struct k_work *work)
+// 更新对外快照（只在工作队列中调用，单写者）
+static void publish_snapshot(struct charging_monitor_data *data)
 {
-    ARG_UNUSED(work);
-    struct charging_monitor_data *data = get_data();
-    
-    // 直接读取当前状态
-    charging_state_t current_state = data->current_state;
-    
-    // 执行回调
-    if (data->callback) {
-        data->callback(current_state);
-    }
+    atomic_val_t next = atomic_get(&data->shadow_gen) + 1;
+    struct charging_monitor_shadow *slot = &data->shadow[next & 1];
+
+    // 写入读者当前不会选中的槽位，完成后再发布新代数
+    slot->state = data->current_state;
+    slot->mode = data->mode;
+    slot->since_ms = data->last_state_change_time;
+
+    barrier_dmem_fence_full();
+    atomic_set(&data->shadow_gen, next);
 }
 
-// 状态变化防抖检查
-static bool should_process_state_change(struct charging_monitor_data *data, 
-                                       charging_state_t new_state)
+// 发布充电状态事件（在状态检查工作中同步分发给所有监听者）
+static void publish_state(struct charging_monitor_data *data)
 {
-    int64_t now = k_uptime_get();
-    
-    // 如果是错误状态，总是处理（需要尽快恢复）
-    if (new_state == CHARGING_STATE_ERROR || 
-        data->current_state == CHARGING_STATE_ERROR) {
-        return true;
-    }
-    
-    // 如果是由中断触发的状态检查，放宽防抖要求（中断表示有实际变化）
-    if (data->in_interrupt) {
-        // 中断模式下，防抖时间减半
-        if (now - data->last_state_change_time < DEBOUNCE_TIME_MS / 2) {
-            LOG_DBG("Interrupt-triggered state change debounced");
-            return false;
+    data->report_pending = false;
+    publish_snapshot(data);
+
+    raise_zmk_charging_state_changed((struct zmk_charging_state_changed){
+        .dev = data->dev,
+        .state = data->current_state,
+        .timestamp = k_uptime_get(),
+    });
+}
+
+// 状态变化防抖检查：返回0表示立即处理，否则返回防抖窗口剩余的毫秒数
+static uint32_t state_change_delay_ms(struct charging_monitor_data *data,
+                                      charging_state_t new_state, bool from_irq)
+{
+    const struct charging_monitor_config *cfg = data->dev->config;
+    int64_t elapsed = k_uptime_get() - data->last_state_change_time;
+
+    // 退出故障状态总是立即处理（需要尽快恢复）
+    if (data->current_state == CHARGING_STATE_FAULT) {
+        return 0;
+    }
+
+    // 进入故障状态需要确认：插拔或充电阶段切换时CHRG/STDBY可能短暂呈现故障组合，
+    // 连续读到故障组合满半个防抖窗口后才认定
+    if (new_state == CHARGING_STATE_FAULT) {
+        uint32_t confirm = cfg->debounce_ms / 2;
+        int64_t seen = k_uptime_get() - data->fault_seen_time;
+
+        if (seen < confirm) {
+            LOG_DBG("Fault state awaiting confirmation");
+            return confirm - (uint32_t)seen;
         }
-        return true;
+        return 0;
+    }
+
+    // USB插拔由VBUS直接判定，不做防抖，拔线后立即通知关闭LED
+    if (new_state == CHARGING_STATE_DISCHARGING ||
+        data->current_state == CHARGING_STATE_DISCHARGING) {
+        return 0;
     }
-    
-    // 防抖：相同状态变化至少间隔DEBOUNCE_TIME_MS
-    if (now - data->last_state_change_time < DEBOUNCE_TIME_MS) {
-        LOG_DBG("Polling state change debounced: %d -> %d", 
+
+    // 如果是由中断触发的状态检查，放宽防抖要求（中断表示有实际变化），防抖时间减半
+    uint32_t window = from_irq ? cfg->debounce_ms / 2 : cfg->debounce_ms;
+
+    if (elapsed < window) {
+        LOG_DBG("%s state change debounced: %d -> %d", from_irq ? "Interrupt" : "Polling",
                 data->current_state, new_state);
-        return false;
+        return window - (uint32_t)elapsed;
     }
-    
-    return true;
+
+    return 0;
 }
 
 // 智能轮询间隔计算（根据模式调整）
-static uint32_t calculate_polling_interval(struct charging_monitor_data *data, 
+static uint32_t calculate_polling_interval(struct charging_monitor_data *data,
                                           charging_state_t state, bool system_idle)
 {
+    const struct charging_monitor_config *cfg = data->dev->config;
     uint32_t base_interval;
-    
+
     // 根据工作模式调整基础间隔
     switch (data->mode) {
-    case MODE_INTERRUPT:
+    case CHARGING_MONITOR_MODE_INTERRUPT:
         // 中断模式下，轮询作为后备，间隔较长
-        base_interval = POLL_INTERVAL_INTERRUPT_MS;
+        base_interval = cfg->poll_interrupt_ms;
         break;
-    case MODE_POLLING:
-    case MODE_ERROR:
+    case CHARGING_MONITOR_MODE_POLLING:
+    case CHARGING_MONITOR_MODE_ERROR:
     default:
         // 轮询模式下，根据状态选择间隔
         switch (state) {
         case CHARGING_STATE_CHARGING:
-            base_interval = POLL_INTERVAL_CHARGING_MS;
+            base_interval = cfg->poll_charging_ms;
             break;
         case CHARGING_STATE_FULL:
-            base_interval = POLL_INTERVAL_FULL_MS;
+        case CHARGING_STATE_DISCHARGING:
+            base_interval = cfg->poll_full_ms;
             break;
-        case CHARGING_STATE_ERROR:
+        case CHARGING_STATE_FAULT:
             // 错误状态使用退避算法
-            base_interval = POLL_INTERVAL_ERROR_MS * (1 + (data->consecutive_errors / 2));
-            if (base_interval > 120000) base_interval = 120000; // 最大2分钟
+            base_interval = cfg->poll_error_ms * (1 + (data->consecutive_errors / 2));
+            if (base_interval > MAX_ERROR_BACKOFF_MS) base_interval = MAX_ERROR_BACKOFF_MS;
             break;
         default:
-            base_interval = POLL_INTERVAL_FULL_MS;
+            base_interval = cfg->poll_full_ms;
         }
         break;
     }
-    
+
     // 应用空闲乘数
     if (system_idle && state != CHARGING_STATE_CHARGING) {
-        base_interval *= IDLE_MULTIPLIER;
+        base_interval *= cfg->idle_multiplier;
     }
-    
+
     return base_interval;
 }
 
-// 记录活动时间
-static void record_activity(void)
+// 调度下一次定时轮询；无节拍中断模式下完全依赖边沿中断，不再定时唤醒
+static void schedule_next_poll(struct charging_monitor_data *data, uint32_t interval)
 {
-    struct charging_monitor_data *data = get_data();
-    data->last_activity_time = k_uptime_get();
-    
-    // 如果从空闲状态恢复，记录日志
-    if (data->system_idle) {
-        data->system_idle = false;
-        LOG_DBG("Activity detected, exiting idle mode");
+    if (IS_ENABLED(CONFIG_ZMK_CHARGING_MONITOR_TICKLESS) && data->mode == CHARGING_MONITOR_MODE_INTERRUPT) {
+        return;
+    }
+
+    atomic_set(&data->timer_poll, 1);
+    k_work_reschedule_for_queue(paging_work_q(), &data->status_check_work, K_MSEC(interval));
+}
+
+// 防抖窗口结束后再检查一次被过滤的状态变化；无节拍模式下同样生效，
+// 否则被过滤的变化要等到下一次无关的边沿或活动切换才会被发现
+static void schedule_recheck(struct charging_monitor_data *data, uint32_t delay_ms, bool from_irq)
+{
+    if (from_irq) {
+        // 保留中断触发的防抖规则
+        atomic_set(&data->irq_latched, 1);
     }
+    atomic_clear(&data->timer_poll);
+    k_work_reschedule_for_queue(paging_work_q(), &data->status_check_work, K_MSEC(delay_ms));
 }
 
 // 检查系统是否空闲
-static bool check_system_idle(void)
+static bool check_system_idle(struct charging_monitor_data *data)
 {
-    struct charging_monitor_data *data = get_data();
+    const struct charging_monitor_config *cfg = data->dev->config;
     int64_t now = k_uptime_get();
-    bool is_idle = ((now - data->last_activity_time) > IDLE_TIMEOUT_MS);
-    
+    bool is_idle = ((now - data->last_activity_time) > cfg->idle_timeout_ms);
+
     // 只有状态变化时才记录日志
     if (is_idle != data->system_idle) {
         data->system_idle = is_idle;
         LOG_DBG("System %s", is_idle ? "idle" : "active");
     }
-    
+
     return is_idle;
 }
 
+// 读取USB VBUS是否存在；未启用ZMK USB时无法判断，视为存在
+static bool vbus_present(void)
+{
+#if IS_ENABLED(CONFIG_ZMK_USB)
+    return zmk_usb_is_powered();
+#else
+    return true;
+#endif
+}
+
+// 融合VBUS、CHRG和可选的STDBY引脚，得到充电器状态（TP4056真值表）：
+//   无VBUS                     -> DISCHARGING
+//   CHRG有效，STDBY无效        -> CHARGING
+//   CHRG无效，STDBY有效        -> FULL
+//   CHRG和STDBY同时有效        -> FAULT
+//   CHRG和STDBY同时无效        -> 有VBUS时为FAULT（温度异常/无电池），
+//                                 无法判断VBUS时视为DISCHARGING
+// 未接STDBY时CHRG无效即视为FULL
+static int read_charger_state(struct charging_monitor_data *data, charging_state_t *state)
+{
+    const struct charging_monitor_config *cfg = data->dev->config;
+
+    if (!vbus_present()) {
+        *state = CHARGING_STATE_DISCHARGING;
+        return 0;
+    }
+
+    int chrg = gpio_pin_get_dt(&cfg->chrg_gpio);
+    if (chrg < 0) {
+        LOG_ERR("Failed to read CHRG pin: %d", chrg);
+        return chrg;
+    }
+
+    if (cfg->stdby_gpio.port == NULL) {
+        *state = chrg ? CHARGING_STATE_CHARGING : CHARGING_STATE_FULL;
+        return 0;
+    }
+
+    int stdby = gpio_pin_get_dt(&cfg->stdby_gpio);
+    if (stdby < 0) {
+        LOG_ERR("Failed to read STDBY pin: %d", stdby);
+        return stdby;
+    }
+
+    if (chrg && !stdby) {
+        *state = CHARGING_STATE_CHARGING;
+    } else if (!chrg && stdby) {
+        *state = CHARGING_STATE_FULL;
+    } else if (chrg && stdby) {
+        *state = CHARGING_STATE_FAULT;
+    } else {
+        *state = IS_ENABLED(CONFIG_ZMK_USB) ? CHARGING_STATE_FAULT : CHARGING_STATE_DISCHARGING;
+    }
+
+    return 0;
+}
+
 // 尝试启用中断模式
 static bool try_enable_interrupt(struct charging_monitor_data *data)
 {
+    const struct charging_monitor_config *cfg = data->dev->config;
     int ret;
-    
+
     // 配置GPIO中断（双边沿触发）
-    ret = gpio_pin_interrupt_configure(data->gpio_dev, CHARGING_GPIO_PIN,
-                                      GPIO_INT_EDGE_BOTH);
+    ret = gpio_pin_interrupt_configure_dt(&cfg->chrg_gpio, GPIO_INT_EDGE_BOTH);
     if (ret < 0) {
         LOG_WRN("Failed to configure GPIO interrupt: %d (falling back to polling)", ret);
         return false;
     }
-    
+
     // 初始化GPIO回调
-    gpio_init_callback(&data->gpio_cb, gpio_interrupt_handler, BIT(CHARGING_GPIO_PIN));
-    
+    gpio_init_callback(&data->gpio_cb, gpio_interrupt_handler, BIT(cfg->chrg_gpio.pin));
+
     // 添加回调
-    ret = gpio_add_callback(data->gpio_dev, &data->gpio_cb);
+    ret = gpio_add_callback(cfg->chrg_gpio.port, &data->gpio_cb);
     if (ret < 0) {
         LOG_WRN("Failed to add GPIO callback: %d (falling back to polling)", ret);
-        gpio_pin_interrupt_configure(data->gpio_dev, CHARGING_GPIO_PIN, GPIO_INT_DISABLE);
+        gpio_pin_interrupt_configure_dt(&cfg->chrg_gpio, GPIO_INT_DISABLE);
         return false;
     }
-    
+
+    // STDBY引脚同样使用边沿中断
+    if (cfg->stdby_gpio.port != NULL) {
+        ret = gpio_pin_interrupt_configure_dt(&cfg->stdby_gpio, GPIO_INT_EDGE_BOTH);
+        if (ret == 0) {
+            gpio_init_callback(&data->stdby_cb, stdby_interrupt_handler,
+                               BIT(cfg->stdby_gpio.pin));
+            ret = gpio_add_callback(cfg->stdby_gpio.port, &data->stdby_cb);
+        }
+        if (ret < 0) {
+            LOG_WRN("Failed to enable STDBY interrupt: %d (falling back to polling)", ret);
+            gpio_pin_interrupt_configure_dt(&cfg->stdby_gpio, GPIO_INT_DISABLE);
+            gpio_pin_interrupt_configure_dt(&cfg->chrg_gpio, GPIO_INT_DISABLE);
+            gpio_remove_callback(cfg->chrg_gpio.port, &data->gpio_cb);
+            return false;
+        }
+    }
+
     data->interrupt_enabled = true;
-    data->mode = MODE_INTERRUPT;
+    data->mode = CHARGING_MONITOR_MODE_INTERRUPT;
     LOG_INF("GPIO interrupt enabled for CHRG pin");
-    
+
     return true;
 }
 
@@ -294,246 +512,261 @@ static void status_check_work_handler(struct k_work *work)
 {
     struct k_work_delayable *dwork = k_work_delayable_from_work(work);
     struct charging_monitor_data *data = CONTAINER_OF(dwork, struct charging_monitor_data, status_check_work);
-    
-    if (!data->initialized || !data->gpio_dev) {
+    const struct charging_monitor_config *cfg = data->dev->config;
+
+    if (!data->initialized) {
         LOG_WRN("Charging monitor not initialized");
-        k_work_reschedule(dwork, K_MSEC(POLL_INTERVAL_ERROR_MS));
+        k_work_reschedule_for_queue(paging_work_q(), dwork, K_MSEC(cfg->poll_error_ms));
         return;
     }
-    
+
     // 检查轮询是否激活
     if (!data->polling_active) {
         LOG_DBG("Polling paused");
         return;
     }
-    
+
+    // 取走ISR锁存的边沿
+    bool from_irq = atomic_clear(&data->irq_latched);
+
+    // 取走外部锁存的键盘活动
+    if (atomic_clear(&data->activity_latched)) {
+        record_activity(data);
+    }
+
+    // 统计定时轮询唤醒次数
+    if (atomic_clear(&data->timer_poll)) {
+        data->poll_count++;
+        LOG_DBG("Poll wakeup #%u", data->poll_count);
+    }
+
     // 更新空闲状态
-    bool system_idle = check_system_idle();
-    
-    // 读取CHRG引脚状态
-    int pin_state = gpio_pin_get(data->gpio_dev, CHARGING_GPIO_PIN);
-    
-    if (pin_state < 0) {
-        LOG_ERR("Failed to read CHRG pin: %d", pin_state);
-        
+    bool system_idle = check_system_idle(data);
+
+    // 读取VBUS、CHRG和STDBY，融合为充电器状态
+    charging_state_t new_state;
+    int err = read_charger_state(data, &new_state);
+
+    if (err < 0) {
         // 如果中断模式下出现错误，尝试回退到轮询模式
-        if (data->mode == MODE_INTERRUPT) {
+        if (data->mode == CHARGING_MONITOR_MODE_INTERRUPT) {
             LOG_WRN("Interrupt mode error, falling back to polling");
             data->interrupt_enabled = false;
-            data->mode = MODE_POLLING;
-            gpio_pin_interrupt_configure(data->gpio_dev, CHARGING_GPIO_PIN, GPIO_INT_DISABLE);
+            data->mode = CHARGING_MONITOR_MODE_POLLING;
+            gpio_pin_interrupt_configure_dt(&cfg->chrg_gpio, GPIO_INT_DISABLE);
+            if (cfg->stdby_gpio.port != NULL) {
+                gpio_pin_interrupt_configure_dt(&cfg->stdby_gpio, GPIO_INT_DISABLE);
+            }
+            publish_snapshot(data);
         }
-        
+
         // 增加连续错误计数
         if (data->consecutive_errors < MAX_CONSECUTIVE_ERRORS) {
             data->consecutive_errors++;
         }
-        
-        // 设置为错误状态
-        data->current_state = CHARGING_STATE_ERROR;
-        
+
+        // 设置为故障状态，进入故障时发布一次事件
+        if (data->current_state != CHARGING_STATE_FAULT || data->report_pending) {
+            data->current_state = CHARGING_STATE_FAULT;
+            data->last_state_change_time = k_uptime_get();
+            publish_state(data);
+        }
+
         // 智能调度下一次检查
-        uint32_t interval = calculate_polling_interval(data, CHARGING_STATE_ERROR, system_idle);
-        k_work_reschedule(dwork, K_MSEC(interval));
+        uint32_t interval = calculate_polling_interval(data, CHARGING_STATE_FAULT, system_idle);
+        schedule_next_poll(data, interval);
         return;
     }
-    
+
     // 成功读取，清除错误计数
     data->consecutive_errors = 0;
-    
-    // TP4056 CHRG引脚逻辑：
-    // - pin_state == 1: 引脚有效（正在充电）
-    // - pin_state == 0: 引脚无效（已充满）
-    charging_state_t new_state = (pin_state == 1) ? CHARGING_STATE_CHARGING : CHARGING_STATE_FULL;
-    
+
+    // 记录故障组合首次出现的时间，读到其他组合时作废
+    if (new_state == CHARGING_STATE_FAULT) {
+        if (!data->fault_seen) {
+            data->fault_seen = true;
+            data->fault_seen_time = k_uptime_get();
+        }
+    } else {
+        data->fault_seen = false;
+    }
+
     // 获取当前状态进行比较
     charging_state_t current_state = data->current_state;
-    
+
+    // 被防抖过滤时，防抖窗口结束后需要重新检查
+    uint32_t recheck_ms = 0;
+
     // 状态变化检测（带防抖）
     if (new_state != current_state) {
         // 检查是否需要处理这个状态变化（防抖）
-        if (should_process_state_change(data, new_state)) {
-            const char *old_state_str = (current_state == CHARGING_STATE_CHARGING) ? "CHARGING" : 
-                                       (current_state == CHARGING_STATE_FULL) ? "FULL" : "ERROR";
-            const char *new_state_str = (new_state == CHARGING_STATE_CHARGING) ? "CHARGING" : "FULL";
-            const char *trigger_str = data->in_interrupt ? "interrupt" : "polling";
-            
-            LOG_INF("Charging state changed (%s): %s -> %s", 
-                    trigger_str, old_state_str, new_state_str);
-            
+        recheck_ms = state_change_delay_ms(data, new_state, from_irq);
+        if (recheck_ms == 0) {
+            const char *trigger_str = from_irq ? "interrupt" : "polling";
+
+            LOG_INF("%s: charging state changed (%s): %s -> %s", data->dev->name,
+                    trigger_str, state_to_str(current_state), state_to_str(new_state));
+
             // 更新状态和时间戳
             data->current_state = new_state;
             data->last_state_change_time = k_uptime_get();
-            
-            // 触发异步回调
-            k_work_submit(&data->callback_work);
+
+            // 发布状态变化事件（每次边沿只分发一次）
+            publish_state(data);
         } else {
-            // 防抖过滤掉的状态变化，但仍然记录调试信息
-            LOG_DBG("State change filtered by debounce: %d -> %d", 
-                    current_state, new_state);
+            // 防抖过滤掉的状态变化，防抖窗口结束后重新检查
+            LOG_DBG("State change filtered by debounce: %d -> %d, recheck in %u ms",
+                    current_state, new_state, recheck_ms);
         }
     }
-    
+
+    // 初始化后的第一次检查发布初始状态
+    if (data->report_pending) {
+        publish_state(data);
+    }
+
+    if (recheck_ms > 0) {
+        schedule_recheck(data, recheck_ms, from_irq);
+        return;
+    }
+
     // 智能调度下一次检查
     uint32_t interval = calculate_polling_interval(data, new_state, system_idle);
-    k_work_reschedule(dwork, K_MSEC(interval));
+    schedule_next_poll(data, interval);
 }
 
-// 初始化充电监控器
-int charging_monitor_init(void)
+// 初始化充电监控器实例
+static int charging_monitor_init(const struct device *dev)
 {
-    struct charging_monitor_data *data = get_data();
+    const struct charging_monitor_config *cfg = dev->config;
+    struct charging_monitor_data *data = dev->data;
     int ret;
-    
-    if (data->initialized) {
-        LOG_WRN("Charging monitor already initialized");
-        return 0;
-    }
-    
-    LOG_DBG("Initializing charging monitor with interrupt support");
-    
-    // 获取GPIO设备 - 硬编码使用GPIO1
-    data->gpio_dev = DEVICE_DT_GET(CHARGING_GPIO_PORT);
-    if (!data->gpio_dev) {
-        LOG_ERR("Failed to get GPIO1 device");
-        return -ENODEV;
-    }
-    
-    if (!device_is_ready(data->gpio_dev)) {
-        LOG_ERR("GPIO1 device not ready");
+
+    LOG_DBG("Initializing charging monitor %s with interrupt support", dev->name);
+
+    data->dev = dev;
+    data->current_state = CHARGING_STATE_FAULT;
+    data->polling_active = true;
+    data->mode = CHARGING_MONITOR_MODE_POLLING;
+
+    if (!gpio_is_ready_dt(&cfg->chrg_gpio)) {
+        LOG_ERR("CHRG GPIO device not ready");
         return -ENODEV;
     }
-    
-    // 配置CHRG引脚为输入，上拉电阻
-    ret = gpio_pin_configure(data->gpio_dev, CHARGING_GPIO_PIN, GPIO_INPUT | CHARGING_GPIO_FLAGS);
+
+    // 配置CHRG引脚为输入，极性和上拉由设备树标志决定
+    ret = gpio_pin_configure_dt(&cfg->chrg_gpio, GPIO_INPUT);
     if (ret < 0) {
         LOG_ERR("Failed to configure CHRG GPIO: %d", ret);
         return ret;
     }
-    
-    LOG_INF("Charging monitor configured: GPIO1 pin %d (P1.09), flags: 0x%x", 
-            CHARGING_GPIO_PIN, CHARGING_GPIO_FLAGS);
-    
+
+    LOG_INF("Charging monitor configured: %s pin %d, flags: 0x%x",
+            cfg->chrg_gpio.port->name, cfg->chrg_gpio.pin, cfg->chrg_gpio.dt_flags);
+
+    // 可选的STDBY引脚
+    if (cfg->stdby_gpio.port != NULL) {
+        if (!gpio_is_ready_dt(&cfg->stdby_gpio)) {
+            LOG_ERR("STDBY GPIO device not ready");
+            return -ENODEV;
+        }
+
+        ret = gpio_pin_configure_dt(&cfg->stdby_gpio, GPIO_INPUT);
+        if (ret < 0) {
+            LOG_ERR("Failed to configure STDBY GPIO: %d", ret);
+            return ret;
+        }
+
+        LOG_INF("STDBY pin: %s pin %d", cfg->stdby_gpio.port->name, cfg->stdby_gpio.pin);
+    }
+
     // 初始化工作队列
     k_work_init_delayable(&data->status_check_work, status_check_work_handler);
-    k_work_init(&data->callback_work, callback_work_handler);
     k_work_init(&data->interrupt_work, interrupt_work_handler);
-    
+
     // 尝试启用中断模式
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_STATUS_ISR_TIMING)
+    isr_timing_setup();
+#endif
     bool interrupt_success = try_enable_interrupt(data);
-    
+
     if (interrupt_success) {
-        LOG_INF("Charging monitor operating in interrupt mode");
+        LOG_INF("Charging monitor operating in %s interrupt mode",
+                IS_ENABLED(CONFIG_ZMK_CHARGING_MONITOR_TICKLESS) ? "tickless" : "polled");
     } else {
         LOG_INF("Charging monitor operating in polling mode");
-        data->mode = MODE_POLLING;
+        data->mode = CHARGING_MONITOR_MODE_POLLING;
     }
-    
+
     // 设置初始活动时间
-    record_activity();
-    
+    record_activity(data);
+
     // 读取初始状态
-    int initial_state = gpio_pin_get(data->gpio_dev, CHARGING_GPIO_PIN);
-    if (initial_state >= 0) {
-        data->current_state = (initial_state == 1) ? CHARGING_STATE_CHARGING : CHARGING_STATE_FULL;
+    charging_state_t initial_state;
+    ret = read_charger_state(data, &initial_state);
+    if (ret >= 0) {
+        data->current_state = initial_state;
         data->last_state_change_time = k_uptime_get();
-        
-        LOG_INF("Initial charging state: %s (mode: %s)", 
-                (data->current_state == CHARGING_STATE_CHARGING) ? "CHARGING" : "FULL",
+
+        LOG_INF("Initial charging state: %s (mode: %s)",
+                state_to_str(data->current_state),
                 data->interrupt_enabled ? "interrupt" : "polling");
     } else {
-        LOG_ERR("Failed to read initial CHRG pin state: %d", initial_state);
-        data->current_state = CHARGING_STATE_ERROR;
-        data->mode = MODE_ERROR;
-    }
-    
-    // 根据模式设置初始轮询间隔
-    uint32_t initial_interval;
-    if (data->mode == MODE_INTERRUPT) {
-        initial_interval = POLL_INTERVAL_INTERRUPT_MS;
-    } else {
-        initial_interval = calculate_polling_interval(data, data->current_state, false);
+        LOG_ERR("Failed to read initial charger state: %d", ret);
+        data->current_state = CHARGING_STATE_FAULT;
+        data->mode = CHARGING_MONITOR_MODE_ERROR;
     }
-    
-    // 开始状态监控
-    k_work_reschedule(&data->status_check_work, K_MSEC(initial_interval));
-    
+
+    // 第一次检查在工作队列中立即执行，并发布初始状态事件，
+    // 之后按模式调度轮询间隔
+    publish_snapshot(data);
+    data->report_pending = true;
     data->initialized = true;
+    request_check(data);
+
     LOG_INF("Charging monitor initialized successfully");
-    
-    return 0;
-}
 
-// 注册回调函数
-int charging_monitor_register_callback(charging_state_changed_cb_t callback)
-{
-    struct charging_monitor_data *data = get_data();
-    
-    if (!data->initialized) {
-        LOG_ERR("Charging monitor not initialized");
-        return -ENODEV;
-    }
-    
-    if (!callback) {
-        LOG_ERR("Callback function is NULL");
-        return -EINVAL;
-    }
-    
-    // 直接设置回调函数
-    data->callback = callback;
-    
-    LOG_DBG("Callback registered");
-    
-    // 立即触发一次回调（通过工作队列）
-    k_work_submit(&data->callback_work);
-    
     return 0;
 }
 
-// 获取当前充电状态
+// 获取当前充电状态（从快照槽位读取，可在任意线程或中断中调用）
 charging_state_t charging_monitor_get_state(void)
 {
     struct charging_monitor_data *data = get_data();
-    
+
     if (!data->initialized) {
-        return CHARGING_STATE_ERROR;
+        return CHARGING_STATE_FAULT;
     }
-    
-    return data->current_state;
+
+    // 状态只有一个字，单次读取不会撕裂；槽位与代数同时取得，
+    // 读到的总是某一次已发布的值
+    atomic_val_t gen = atomic_get(&data->shadow_gen);
+    barrier_dmem_fence_full();
+
+    return data->shadow[gen & 1].state;
 }
 
 // 获取充电状态字符串
 const char* charging_monitor_get_state_str(void)
 {
-    charging_state_t state = charging_monitor_get_state();
-    
-    switch (state) {
-    case CHARGING_STATE_CHARGING:
-        return "CHARGING";
-    case CHARGING_STATE_FULL:
-        return "FULL";
-    case CHARGING_STATE_ERROR:
-        return "ERROR";
-    default:
-        return "UNKNOWN";
-    }
+    return state_to_str(charging_monitor_get_state());
 }
 
 // 获取当前工作模式
 const char* charging_monitor_get_mode_str(void)
 {
     struct charging_monitor_data *data = get_data();
-    
+
     if (!data->initialized) {
         return "UNINITIALIZED";
     }
-    
+
     switch (data->mode) {
-    case MODE_POLLING:
+    case CHARGING_MONITOR_MODE_POLLING:
         return "POLLING";
-    case MODE_INTERRUPT:
+    case CHARGING_MONITOR_MODE_INTERRUPT:
         return "INTERRUPT";
-    case MODE_ERROR:
+    case CHARGING_MONITOR_MODE_ERROR:
         return "ERROR";
     default:
         return "UNKNOWN";
@@ -544,27 +777,172 @@ const char* charging_monitor_get_mode_str(void)
 uint32_t charging_monitor_get_interrupt_count(void)
 {
     struct charging_monitor_data *data = get_data();
-    
+
     if (!data->initialized) {
         return 0;
     }
-    
-    return data->interrupt_count;
+
+    return (uint32_t)atomic_get(&data->irq_count);
+}
+
+// 获取一致的状态快照（可在任意线程或中断中调用，不关中断、不加锁）
+int charging_monitor_get_snapshot(struct charging_monitor_snapshot *snapshot)
+{
+    struct charging_monitor_data *data = get_data();
+
+    if (snapshot == NULL) {
+        return -EINVAL;
+    }
+
+    if (!data->initialized) {
+        return -ENODEV;
+    }
+
+    for (int i = 0; i < SNAPSHOT_READ_RETRIES; i++) {
+        atomic_val_t gen = atomic_get(&data->shadow_gen);
+        barrier_dmem_fence_full();
+
+        const struct charging_monitor_shadow *slot = &data->shadow[gen & 1];
+        snapshot->state = slot->state;
+        snapshot->mode = slot->mode;
+        snapshot->since_ms = slot->since_ms;
+
+        barrier_dmem_fence_full();
+
+        // 读取期间代数未变才说明所读槽位未被改写：写者发布 gen+1 后，
+        // 下一次写入的正是本槽位，而此时代数仍为 gen+1
+        if (atomic_get(&data->shadow_gen) == gen) {
+            snapshot->irq_count = (uint32_t)atomic_get(&data->irq_count);
+            return 0;
+        }
+    }
+
+    return -EAGAIN;
+}
+
+// 获取定时轮询唤醒次数
+uint32_t charging_monitor_get_poll_count(void)
+{
+    struct charging_monitor_data *data = get_data();
+
+    if (!data->initialized) {
+        return 0;
+    }
+
+    return data->poll_count;
 }
 
 // 手动触发状态检查
 void charging_monitor_force_check(void)
 {
     struct charging_monitor_data *data = get_data();
-    
+
     if (!data->initialized || !data->polling_active) {
         return;
     }
-    
+
     LOG_DBG("Manual state check triggered");
-    record_activity();
-    
-    // 取消当前可能正在排队的工作，立即触发新的检查
-    k_work_cancel_delayable(&data->status_check_work);
-    k_work_reschedule(&data->status_check_work, K_NO_WAIT);
+    atomic_set(&data->activity_latched, 1);
+
+    // 立即触发新的检查（reschedule会替换正在排队的定时检查）
+    request_check(data);
 }
+
+// 所有实例，供活动事件监听使用
+static const struct device *const monitor_devices[] = {
+    DT_INST_FOREACH_STATUS_OKAY(DEVICE_DT_INST_GET_COMMA)
+};
+
+// ZMK活动状态变化时做一次校验读取，弥补无节拍模式下可能丢失的边沿，
+// 同时以键盘活动作为空闲判断依据
+static int charging_monitor_activity_listener(const zmk_event_t *eh)
+{
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(monitor_devices); i++) {
+        struct charging_monitor_data *data = monitor_devices[i]->data;
+
+        if (!data->initialized || !data->polling_active) {
+            continue;
+        }
+
+        if (ev->state == ZMK_ACTIVITY_ACTIVE) {
+            atomic_set(&data->activity_latched, 1);
+        }
+
+        LOG_DBG("Activity transition (%d), verifying %s", ev->state, monitor_devices[i]->name);
+        request_check(data);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(charging_monitor, charging_monitor_activity_listener);
+ZMK_SUBSCRIPTION(charging_monitor, zmk_activity_state_changed);
+
+#if IS_ENABLED(CONFIG_ZMK_USB)
+// USB插拔时立即重新判定状态，不等待防抖轮询
+static int charging_monitor_usb_listener(const zmk_event_t *eh)
+{
+    if (as_zmk_usb_conn_state_changed(eh) == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(monitor_devices); i++) {
+        struct charging_monitor_data *data = monitor_devices[i]->data;
+
+        if (!data->initialized || !data->polling_active) {
+            continue;
+        }
+
+        LOG_DBG("USB connection changed, checking %s", monitor_devices[i]->name);
+        request_check(data);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(charging_monitor_usb, charging_monitor_usb_listener);
+ZMK_SUBSCRIPTION(charging_monitor_usb, zmk_usb_conn_state_changed);
+#endif
+
+// 无节拍模式下要求CHRG引脚使用nRF GPIO SENSE（PORT事件）检测边沿，
+// 不占用GPIOTE IN通道，也不会阻止系统进入低功耗空闲
+#if IS_ENABLED(CONFIG_ZMK_CHARGING_MONITOR_TICKLESS) && IS_ENABLED(CONFIG_SOC_FAMILY_NRF)
+#define CHARGING_MONITOR_CHECK_SENSE_PIN(inst, prop)                                   \
+    BUILD_ASSERT(DT_PROP_OR(DT_INST_GPIO_CTLR(inst, prop), sense_edge_mask, 0) &       \
+                 BIT(DT_INST_GPIO_PIN(inst, prop)),                                    \
+                 "Tickless charging monitor needs " #prop " in the port's sense-edge-mask");
+#define CHARGING_MONITOR_CHECK_SENSE(inst)                                              \
+    CHARGING_MONITOR_CHECK_SENSE_PIN(inst, chrg_gpios)                                  \
+    IF_ENABLED(DT_INST_NODE_HAS_PROP(inst, stdby_gpios),                                \
+               (CHARGING_MONITOR_CHECK_SENSE_PIN(inst, stdby_gpios)))
+#else
+#define CHARGING_MONITOR_CHECK_SENSE(inst)
+#endif
+
+// 实例化：所有参数在编译期从设备树节点展开，无运行时查找
+#define CHARGING_MONITOR_DEFINE(inst)                                               \
+    CHARGING_MONITOR_CHECK_SENSE(inst)                                               \
+    static struct charging_monitor_data charging_monitor_data_##inst;                \
+    static const struct charging_monitor_config charging_monitor_config_##inst = {   \
+        .chrg_gpio = GPIO_DT_SPEC_INST_GET(inst, chrg_gpios),                        \
+        .stdby_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, stdby_gpios, {0}),              \
+        .debounce_ms = DT_INST_PROP(inst, debounce_ms),                              \
+        .interrupt_debounce_ms = DT_INST_PROP(inst, interrupt_debounce_ms),          \
+        .poll_charging_ms = DT_INST_PROP(inst, poll_charging_ms),                    \
+        .poll_full_ms = DT_INST_PROP(inst, poll_full_ms),                            \
+        .poll_error_ms = DT_INST_PROP(inst, poll_error_ms),                          \
+        .poll_interrupt_ms = DT_INST_PROP(inst, poll_interrupt_ms),                  \
+        .idle_timeout_ms = DT_INST_PROP(inst, idle_timeout_ms),                      \
+        .idle_multiplier = DT_INST_PROP(inst, idle_multiplier),                      \
+    };                                                                               \
+    DEVICE_DT_INST_DEFINE(inst, charging_monitor_init, NULL,                         \
+                          &charging_monitor_data_##inst,                             \
+                          &charging_monitor_config_##inst,                           \
+                          APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(CHARGING_MONITOR_DEFINE)
@@ -6,24 +6,44 @@
 extern "C" {
 #endif
 
-// 充电状态枚举
+// 充电状态枚举（融合USB VBUS、CHRG和可选的STDBY引脚）
 typedef enum {
-    CHARGING_STATE_CHARGING = 0,    // 正在充电 (CHRG低电平)
-    CHARGING_STATE_FULL,            // 已充满 (CHRG高电平)
-    CHARGING_STATE_ERROR            // 错误状态
+    CHARGING_STATE_DISCHARGING = 0, // 未接USB，电池供电
+    CHARGING_STATE_CHARGING,        // 正在充电 (CHRG有效)
+    CHARGING_STATE_FULL,            // 已充满 (STDBY有效，或未接STDBY时CHRG无效)
+    CHARGING_STATE_FAULT            // 充电器故障或引脚读取失败
 } charging_state_t;
 
-// 充电状态变化回调函数类型
-typedef void (*charging_state_changed_cb_t)(charging_state_t new_state);
+// 充电监控器工作模式
+typedef enum {
+    CHARGING_MONITOR_MODE_POLLING = 0,   // 纯轮询模式
+    CHARGING_MONITOR_MODE_INTERRUPT,     // 中断模式（主）+轮询（后备）；无节拍模式下不轮询
+    CHARGING_MONITOR_MODE_ERROR          // 错误模式，回退到轮询
+} charging_monitor_mode_t;
+
+// 一致的状态快照
+struct charging_monitor_snapshot {
+    charging_state_t state;
+    charging_monitor_mode_t mode;
+    int64_t since_ms;                    // 进入当前状态时的系统运行时间
+    uint32_t irq_count;                  // 累计中断次数
+};
+
+// 状态变化通过 zmk_charging_state_changed 事件发布，
+// 见 events/charging_state_changed.h
 
+// 以下API作用于主实例（chosen zmk,charging-monitor，未指定时为第0个实例），
+// 多实例时可通过事件中的 dev 字段区分来源
 // API接口
-int charging_monitor_init(void);
-int charging_monitor_register_callback(charging_state_changed_cb_t callback);
 charging_state_t charging_monitor_get_state(void);
 const char* charging_monitor_get_state_str(void);
 const char* charging_monitor_get_mode_str(void);
 uint32_t charging_monitor_get_interrupt_count(void);
+uint32_t charging_monitor_get_poll_count(void);
 void charging_monitor_force_check(void);
+// 读取一致的快照，可在任意上下文调用；返回 -ENODEV 表示未初始化，
+// -EAGAIN 表示连续被写者打断（极少发生，可稍后重试）
+int charging_monitor_get_snapshot(struct charging_monitor_snapshot *snapshot);
 
 #ifdef __cplusplus
 }
@@ -3,10 +3,12 @@
 LOG_MODULE_REGISTER(charging_rgb, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/rgb_underglow.h>
+#include <zmk/event_manager.h>
 #include "charging_monitor.h"
+#include "events/charging_state_changed.h"
 
-// 充电状态变化回调函数
-static void on_charging_state_changed(enum charging_state new_state)
+// 充电状态变化处理
+static void on_charging_state_changed(charging_state_t new_state)
 {
     switch (new_state) {
     case CHARGING_STATE_CHARGING:
@@ -20,36 +22,22 @@ static void on_charging_state_changed(enum charging_state new_state)
         zmk_rgb_underglow_off();
         break;
         
-    case CHARGING_STATE_ERROR:
-        LOG_WRN("Charging state error - Leaving RGB underglow as is");
+    case CHARGING_STATE_FAULT:
+        LOG_WRN("Charger fault - Leaving RGB underglow as is");
         break;
     }
 }
 
-// 初始化RGB控制器
-static int charging_rgb_controller_init(void)
+// 充电状态事件监听
+static int charging_rgb_event_listener(const zmk_event_t *eh)
 {
-    int ret;
-    
-    // 初始化充电监控器
-    ret = charging_monitor_init();
-    if (ret != 0) {
-        LOG_ERR("Failed to initialize charging monitor: %d", ret);
-        return ret;
-    }
-    
-    // 注册回调到充电监控器
-    ret = charging_monitor_register_callback(on_charging_state_changed);
-    if (ret != 0) {
-        LOG_ERR("Failed to register RGB underglow callback: %d", ret);
-        return ret;
+    const struct zmk_charging_state_changed *ev = as_zmk_charging_state_changed(eh);
+    if (ev) {
+        on_charging_state_changed(ev->state);
     }
     
-    LOG_INF("Charging RGB underglow controller initialized");
-    return 0;
+    return ZMK_EV_EVENT_BUBBLE;
 }
 
-// 只有在启用RGB充电控制时才编译此初始化
-#ifdef CONFIG_ZMK_CHARGING_RGB_CONTROL
-SYS_INIT(charging_rgb_controller_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
-#endif
\ No newline at end of file
+ZMK_LISTENER(charging_rgb, charging_rgb_event_listener);
+ZMK_SUBSCRIPTION(charging_rgb, zmk_charging_state_changed);
\ No newline at end of file
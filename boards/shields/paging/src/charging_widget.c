@@ -0,0 +1,132 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+
+#include "charging_monitor.h"
+#include "charging_widget.h"
+#include "events/charging_state_changed.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// 充电动画帧间隔，帧率上限 4 fps
+#define ANIM_PERIOD_MS  (1000 / CONFIG_ZMK_PAGING_CHARGING_WIDGET_FPS)
+// 图标区域固定宽度，切换图标时只重绘这一块
+#define ICON_WIDTH      20
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+struct charging_widget_state {
+    charging_state_t state;
+};
+
+// 充电动画：电量格依次增加
+static const char *const charge_frames[] = {
+    LV_SYMBOL_BATTERY_EMPTY, LV_SYMBOL_BATTERY_1, LV_SYMBOL_BATTERY_2,
+    LV_SYMBOL_BATTERY_3,     LV_SYMBOL_BATTERY_FULL,
+};
+
+// 动画由 LVGL 定时器驱动，与状态屏刷新在同一上下文中运行，熄屏时随显示定时器一起停止
+static lv_timer_t *anim_timer;
+static uint8_t anim_frame;
+static const char *shown_text;
+static bool shown_hidden = true;
+
+static void set_icon(const char *text)
+{
+    struct charging_widget *widget;
+    bool hidden = (text == NULL);
+
+    // 内容未变化时不触碰控件，避免产生失效区域
+    if (text == shown_text && hidden == shown_hidden) {
+        return;
+    }
+
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        if (hidden) {
+            lv_obj_add_flag(widget->obj, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_label_set_text_static(widget->obj, text);
+            lv_obj_clear_flag(widget->obj, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+
+    shown_text = text;
+    shown_hidden = hidden;
+}
+
+static void anim_timer_cb(lv_timer_t *timer)
+{
+    ARG_UNUSED(timer);
+
+    anim_frame = (anim_frame + 1) % ARRAY_SIZE(charge_frames);
+    set_icon(charge_frames[anim_frame]);
+}
+
+static void charging_widget_update_cb(struct charging_widget_state state)
+{
+    if (state.state == CHARGING_STATE_CHARGING) {
+        anim_frame = 0;
+        set_icon(charge_frames[0]);
+        lv_timer_reset(anim_timer);
+        lv_timer_resume(anim_timer);
+        return;
+    }
+
+    lv_timer_pause(anim_timer);
+
+    switch (state.state) {
+    case CHARGING_STATE_FULL:
+        // 电量控件旁已有电池图标，充满时用对勾而不是再画一个满电池
+        set_icon(LV_SYMBOL_OK);
+        break;
+    case CHARGING_STATE_FAULT:
+        set_icon(LV_SYMBOL_WARNING);
+        break;
+    default:
+        set_icon(NULL);
+        break;
+    }
+}
+
+static struct charging_widget_state charging_widget_get_state(const zmk_event_t *eh)
+{
+    const struct zmk_charging_state_changed *ev =
+        eh ? as_zmk_charging_state_changed(eh) : NULL;
+
+    return (struct charging_widget_state){
+        .state = ev ? ev->state : charging_monitor_get_state(),
+    };
+}
+
+ZMK_DISPLAY_WIDGET_LISTENER(widget_charging_status, struct charging_widget_state,
+                            charging_widget_update_cb, charging_widget_get_state)
+ZMK_SUBSCRIPTION(widget_charging_status, zmk_charging_state_changed);
+
+int charging_widget_init(struct charging_widget *widget, lv_obj_t *parent)
+{
+    widget->obj = lv_label_create(parent);
+    lv_obj_set_width(widget->obj, ICON_WIDTH);
+    lv_obj_set_style_text_align(widget->obj, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+    lv_obj_add_flag(widget->obj, LV_OBJ_FLAG_HIDDEN);
+
+    sys_slist_append(&widgets, &widget->node);
+
+    if (anim_timer == NULL) {
+        anim_timer = lv_timer_create(anim_timer_cb, ANIM_PERIOD_MS, NULL);
+        lv_timer_pause(anim_timer);
+    }
+
+    // 新控件需要按当前状态重新设置一次
+    shown_text = NULL;
+    shown_hidden = true;
+    widget_charging_status_init();
+    return 0;
+}
+
+lv_obj_t *charging_widget_obj(struct charging_widget *widget)
+{
+    return widget->obj;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 状态屏充电图标：充电、充满、故障三种状态，未充电时隐藏
+struct charging_widget {
+    sys_snode_t node;
+    lv_obj_t *obj;
+};
+
+int charging_widget_init(struct charging_widget *widget, lv_obj_t *parent);
+lv_obj_t *charging_widget_obj(struct charging_widget *widget);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,84 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+
+#include "display_refresh.h"
+
+LOG_MODULE_REGISTER(display_refresh, CONFIG_ZMK_LOG_LEVEL);
+
+#define FRAME_MS CONFIG_ZMK_PAGING_DISPLAY_FRAME_MS
+
+// 刷新合并：LVGL 默认每个刷新周期检查一次失效区域，各控件在不同时刻失效时
+// 会各自触发一次刷新。这里把刷新定时器周期改为帧预算，并在一帧内的首个失效
+// 区域到来时重置定时器，使预算窗口内的所有失效合并为一次刷新。
+// 失效经 rounder_cb 计数：同一 tick 内的失效（一次控件更新）只计一次；
+// 刷新过程中 LVGL 计算可渲染行数时也会调用 rounder_cb，这些调用不计入。
+// 刷新完成经 monitor_cb 计数。
+static lv_timer_t *refr_timer;
+static void (*orig_rounder_cb)(struct _lv_disp_drv_t *drv, lv_area_t *area);
+static void (*orig_monitor_cb)(struct _lv_disp_drv_t *drv, uint32_t time, uint32_t px);
+static bool frame_pending;
+static uint32_t last_request_tick;
+static uint32_t requested;
+static uint32_t emitted;
+
+static void refresh_rounder_cb(struct _lv_disp_drv_t *drv, lv_area_t *area)
+{
+    if (orig_rounder_cb) {
+        orig_rounder_cb(drv, area);
+    }
+
+    // 渲染中的调用不是新的失效，也不能在刷新中途重置定时器
+    if (_lv_refr_get_disp_refreshing() != NULL) {
+        return;
+    }
+
+    uint32_t tick = lv_tick_get();
+
+    if (!frame_pending || tick != last_request_tick) {
+        requested++;
+        last_request_tick = tick;
+    }
+
+    if (!frame_pending) {
+        // 本帧首个失效区域：从此刻起计满一个帧预算再刷新
+        frame_pending = true;
+        lv_timer_reset(refr_timer);
+    }
+}
+
+static void refresh_monitor_cb(struct _lv_disp_drv_t *drv, uint32_t time, uint32_t px)
+{
+    if (orig_monitor_cb) {
+        orig_monitor_cb(drv, time, px);
+    }
+
+    frame_pending = false;
+    emitted++;
+    LOG_DBG("Frame %u: %u px in %u ms, %u invalidations so far", emitted, px, time, requested);
+}
+
+void display_refresh_init(void)
+{
+    lv_disp_t *disp = lv_disp_get_default();
+
+    if (disp == NULL || refr_timer != NULL) {
+        return;
+    }
+
+    refr_timer = _lv_disp_get_refr_timer(disp);
+    lv_timer_set_period(refr_timer, FRAME_MS);
+
+    orig_rounder_cb = disp->driver->rounder_cb;
+    orig_monitor_cb = disp->driver->monitor_cb;
+    disp->driver->rounder_cb = refresh_rounder_cb;
+    disp->driver->monitor_cb = refresh_monitor_cb;
+
+    LOG_INF("Display refresh coalescing enabled (%d ms frame budget)", FRAME_MS);
+}
+
+void display_refresh_get_stats(struct display_refresh_stats *stats)
+{
+    stats->requested = requested;
+    stats->emitted = emitted;
+}
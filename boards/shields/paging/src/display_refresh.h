@@ -0,0 +1,24 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 显示刷新调度统计
+struct display_refresh_stats {
+    uint32_t requested;     // 控件更新引起的失效次数，同一 tick 内的多个区域计一次
+                            //（不合并时各自触发一次刷新）
+    uint32_t emitted;       // 实际完成的刷新帧数
+};
+
+// 在 LVGL 上下文中调用一次（状态屏创建时），接管默认显示器的刷新定时器
+void display_refresh_init(void);
+
+// 获取刷新统计
+void display_refresh_get_stats(struct display_refresh_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,9 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include "events/charging_state_changed.h"
+
+ZMK_EVENT_IMPL(zmk_charging_state_changed);
@@ -0,0 +1,18 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+#include "charging_monitor.h"
+
+struct zmk_charging_state_changed {
+    const struct device *dev;          // 发布事件的充电监控器实例
+    charging_state_t state;
+    int64_t timestamp;
+};
+
+ZMK_EVENT_DECLARE(zmk_charging_state_changed);
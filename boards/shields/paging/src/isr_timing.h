@@ -0,0 +1,42 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/timing/timing.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 充电引脚中断耗时探针：充电监控器和充电呼吸灯谁拥有引脚就由谁使用，
+// 中断中只更新统计，报告由延后的工作输出
+struct isr_timing {
+    uint32_t max_ns;    // 最长一次中断耗时
+    uint32_t count;     // 已测量的中断次数
+};
+
+// 在初始化中调用，可重复调用
+static inline void isr_timing_setup(void)
+{
+    timing_init();
+    timing_start();
+}
+
+static inline timing_t isr_timing_begin(void)
+{
+    return timing_counter_get();
+}
+
+static inline void isr_timing_end(struct isr_timing *t, timing_t start)
+{
+    timing_t end = timing_counter_get();
+    uint32_t ns = (uint32_t)timing_cycles_to_ns(timing_cycles_get(&start, &end));
+
+    if (ns > t->max_ns) {
+        t->max_ns = ns;
+    }
+    t->count++;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,328 @@
+#define DT_DRV_COMPAT zmk_led_compositor
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/init.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/led.h>
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/drivers/led_strip.h>
+#include <zephyr/logging/log.h>
+
+#include "led_compositor.h"
+#include "paging_workqueue.h"
+
+LOG_MODULE_REGISTER(led_compositor, CONFIG_ZMK_LOG_LEVEL);
+
+#define COMP_HAS_PWM    DT_INST_NODE_HAS_PROP(0, pwms)
+#define COMP_HAS_BT     DT_INST_NODE_HAS_PROP(0, bt_gpios)
+#define COMP_HAS_STRIP  DT_INST_NODE_HAS_PROP(0, led_strip)
+#define COMP_HAS_LAYER  DT_INST_NODE_HAS_PROP(0, layer_led)
+#define COMP_STRIP_LEN                                                                  \
+    COND_CODE_1(COMP_HAS_STRIP, (DT_PROP(DT_INST_PHANDLE(0, led_strip), chain_length)), (0))
+#define COMP_MAX_PIXELS MAX(1, COMP_STRIP_LEN)
+#define COMP_FRAME_MS   DT_INST_PROP(0, frame_ms)
+
+#if COMP_HAS_PWM
+static const struct pwm_dt_spec comp_pwm = PWM_DT_SPEC_INST_GET(0);
+#endif
+#if COMP_HAS_BT
+static const struct gpio_dt_spec comp_bt = GPIO_DT_SPEC_INST_GET(0, bt_gpios);
+#endif
+#if COMP_HAS_STRIP
+static const struct device *const comp_strip = DEVICE_DT_GET(DT_INST_PHANDLE(0, led_strip));
+// led_strip_update_rgb 可能改写传入的缓冲区，推送时使用副本
+static struct led_rgb strip_scratch[COMP_STRIP_LEN];
+#endif
+#if COMP_HAS_LAYER
+static const struct device *const comp_layer_led = DEVICE_DT_GET(DT_INST_PHANDLE(0, layer_led));
+#define COMP_LAYER_LED_INDEX DT_INST_PROP(0, layer_led_index)
+#endif
+
+// 每个物理输出的合成状态
+struct comp_output {
+    sys_slist_t layers;                     // 按优先级升序
+    struct led_rgb frame[COMP_MAX_PIXELS];  // 本帧合成结果
+    struct led_rgb shown[COMP_MAX_PIXELS];  // 上次推送到硬件的内容
+    struct led_comp_layer *offloaded;       // 正由外设自主播放的图层
+    uint8_t size;
+    bool dirty;                             // 强制推送（初始化或硬件卸载结束后）
+};
+
+static struct comp_output outputs[LED_COMP_OUTPUT_COUNT] = {
+    [LED_COMP_OUTPUT_PWM] = { .size = COMP_HAS_PWM ? 1 : 0, .dirty = true },
+    [LED_COMP_OUTPUT_BT] = { .size = COMP_HAS_BT ? 1 : 0, .dirty = true },
+    [LED_COMP_OUTPUT_STRIP] = { .size = COMP_STRIP_LEN, .dirty = true },
+    [LED_COMP_OUTPUT_LAYER] = { .size = COMP_HAS_LAYER ? 1 : 0, .dirty = true },
+};
+
+static K_MUTEX_DEFINE(comp_lock);
+static bool comp_ready;
+static uint32_t frame_count;
+static uint32_t push_count;
+
+static void frame_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(frame_work, frame_work_handler);
+
+// 单色输出的亮度取RGB最大分量
+static uint8_t pixel_level(const struct led_rgb *px)
+{
+    return MAX(px->r, MAX(px->g, px->b));
+}
+
+static void push_output(enum led_comp_output id, struct comp_output *out)
+{
+    int ret = 0;
+
+    switch (id) {
+    case LED_COMP_OUTPUT_PWM:
+#if COMP_HAS_PWM
+        ret = pwm_set_dt(&comp_pwm, comp_pwm.period,
+                         ((uint64_t)comp_pwm.period * pixel_level(&out->frame[0])) / 255U);
+#endif
+        break;
+    case LED_COMP_OUTPUT_BT:
+#if COMP_HAS_BT
+        ret = gpio_pin_set_dt(&comp_bt, pixel_level(&out->frame[0]) > 0);
+#endif
+        break;
+    case LED_COMP_OUTPUT_STRIP:
+#if COMP_HAS_STRIP
+        memcpy(strip_scratch, out->frame, sizeof(strip_scratch));
+        ret = led_strip_update_rgb(comp_strip, strip_scratch, COMP_STRIP_LEN);
+#endif
+        break;
+    case LED_COMP_OUTPUT_LAYER:
+#if COMP_HAS_LAYER
+    {
+        const uint8_t color[3] = { out->frame[0].r, out->frame[0].g, out->frame[0].b };
+
+        ret = led_set_color(comp_layer_led, COMP_LAYER_LED_INDEX, 3, color);
+    }
+#endif
+        break;
+    default:
+        break;
+    }
+
+    if (ret < 0) {
+        LOG_WRN("Failed to update output %d: %d", id, ret);
+        return;
+    }
+
+    memcpy(out->shown, out->frame, sizeof(out->shown));
+    out->dirty = false;
+    push_count++;
+}
+
+// 最上层图层覆盖整个输出且提供硬件钩子时交给外设播放
+static void update_offload(struct comp_output *out)
+{
+    sys_snode_t *tail = sys_slist_peek_tail(&out->layers);
+    struct led_comp_layer *top =
+        tail ? CONTAINER_OF(tail, struct led_comp_layer, node) : NULL;
+
+    if (out->offloaded && out->offloaded != top) {
+        out->offloaded->hw_stop(out->offloaded);
+        out->offloaded->hw_running = false;
+        out->offloaded = NULL;
+        out->dirty = true;
+    }
+
+    if (top && !out->offloaded && top->hw_start && top->hw_stop && !top->hw_failed &&
+        top->first == 0 && top->count >= out->size) {
+        if (top->hw_start(top) == 0) {
+            top->hw_running = true;
+            out->offloaded = top;
+        } else {
+            LOG_WRN("Hardware offload unavailable, rendering in software");
+            top->hw_failed = true;
+        }
+    }
+}
+
+// 合成一个输出，返回距下一次需要合成的毫秒数，无动画图层时返回 UINT32_MAX
+static uint32_t compose_output(enum led_comp_output id, uint32_t now_ms)
+{
+    struct comp_output *out = &outputs[id];
+    struct led_comp_layer *layer;
+    uint32_t next_ms = UINT32_MAX;
+
+    if (out->size == 0) {
+        return UINT32_MAX;
+    }
+
+    update_offload(out);
+    if (out->offloaded) {
+        return UINT32_MAX;
+    }
+
+    // 由低到高依次覆盖
+    memset(out->frame, 0, sizeof(out->frame));
+    SYS_SLIST_FOR_EACH_CONTAINER(&out->layers, layer, node) {
+        layer->render(layer, now_ms, &out->frame[layer->first]);
+        if (layer->animated) {
+            uint32_t layer_next = layer->next_change
+                                      ? MAX(1, layer->next_change(layer, now_ms))
+                                      : COMP_FRAME_MS;
+            next_ms = MIN(next_ms, layer_next);
+        }
+    }
+
+    // 只推送变化的通道
+    if (out->dirty || memcmp(out->frame, out->shown, sizeof(out->frame)) != 0) {
+        push_output(id, out);
+    }
+
+    return next_ms;
+}
+
+// 统一帧时钟：只在有动画图层时运行，按 frame-ms 或图层给出的下一次变化时间唤醒，
+// 静态内容只在变化时合成一次
+static void frame_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    if (!comp_ready) {
+        return;
+    }
+
+    uint32_t now_ms = k_uptime_get_32();
+    uint32_t next_ms = UINT32_MAX;
+
+    k_mutex_lock(&comp_lock, K_FOREVER);
+    for (int i = 0; i < LED_COMP_OUTPUT_COUNT; i++) {
+        next_ms = MIN(next_ms, compose_output(i, now_ms));
+    }
+    frame_count++;
+    k_mutex_unlock(&comp_lock);
+
+    if (next_ms != UINT32_MAX) {
+        k_work_schedule_for_queue(paging_work_q(), &frame_work, K_MSEC(next_ms));
+    }
+}
+
+void led_comp_invalidate(void)
+{
+    k_work_reschedule_for_queue(paging_work_q(), &frame_work, K_NO_WAIT);
+}
+
+void led_comp_layer_show(struct led_comp_layer *layer)
+{
+    struct comp_output *out = &outputs[layer->output];
+
+    if (layer->first + layer->count > out->size) {
+        LOG_ERR("Layer exceeds output %d (%d pixels)", layer->output, out->size);
+        return;
+    }
+
+    k_mutex_lock(&comp_lock, K_FOREVER);
+    if (!layer->visible) {
+        sys_snode_t *prev = NULL;
+        struct led_comp_layer *iter;
+
+        // 同优先级按提交顺序，后提交者在上
+        SYS_SLIST_FOR_EACH_CONTAINER(&out->layers, iter, node) {
+            if (iter->priority > layer->priority) {
+                break;
+            }
+            prev = &iter->node;
+        }
+
+        sys_slist_insert(&out->layers, prev, &layer->node);
+        layer->visible = true;
+        layer->hw_failed = false;
+    }
+    k_mutex_unlock(&comp_lock);
+
+    led_comp_invalidate();
+}
+
+void led_comp_layer_hide(struct led_comp_layer *layer)
+{
+    struct comp_output *out = &outputs[layer->output];
+
+    k_mutex_lock(&comp_lock, K_FOREVER);
+    if (layer->visible) {
+        sys_slist_find_and_remove(&out->layers, &layer->node);
+        layer->visible = false;
+
+        if (out->offloaded == layer) {
+            layer->hw_stop(layer);
+            layer->hw_running = false;
+            out->offloaded = NULL;
+            out->dirty = true;
+        }
+    }
+    k_mutex_unlock(&comp_lock);
+
+    led_comp_invalidate();
+}
+
+uint8_t led_comp_output_size(enum led_comp_output output)
+{
+    return output < LED_COMP_OUTPUT_COUNT ? outputs[output].size : 0;
+}
+
+const struct gpio_dt_spec *led_comp_output_gpio(enum led_comp_output output)
+{
+#if COMP_HAS_BT
+    if (output == LED_COMP_OUTPUT_BT && outputs[output].size > 0) {
+        return &comp_bt;
+    }
+#endif
+    return NULL;
+}
+
+uint32_t led_comp_get_frame_count(void)
+{
+    return frame_count;
+}
+
+uint32_t led_comp_get_push_count(void)
+{
+    return push_count;
+}
+
+static int led_compositor_init(void)
+{
+#if COMP_HAS_PWM
+    if (!pwm_is_ready_dt(&comp_pwm)) {
+        LOG_ERR("PWM device not ready");
+        outputs[LED_COMP_OUTPUT_PWM].size = 0;
+    }
+#endif
+
+#if COMP_HAS_BT
+    if (!gpio_is_ready_dt(&comp_bt) ||
+        gpio_pin_configure_dt(&comp_bt, GPIO_OUTPUT_INACTIVE) < 0) {
+        LOG_ERR("BT status LED not ready");
+        outputs[LED_COMP_OUTPUT_BT].size = 0;
+    }
+#endif
+
+#if COMP_HAS_STRIP
+    if (!device_is_ready(comp_strip)) {
+        LOG_ERR("LED strip not ready");
+        outputs[LED_COMP_OUTPUT_STRIP].size = 0;
+    }
+#endif
+
+#if COMP_HAS_LAYER
+    if (!device_is_ready(comp_layer_led)) {
+        LOG_ERR("Layer LED not ready");
+        outputs[LED_COMP_OUTPUT_LAYER].size = 0;
+    }
+#endif
+
+    // 初始化前提交的图层在首帧统一合成
+    comp_ready = true;
+    led_comp_invalidate();
+
+    LOG_INF("LED compositor initialized (frame %d ms)", COMP_FRAME_MS);
+    return 0;
+}
+
+SYS_INIT(led_compositor_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/led_strip.h>
+#include <zephyr/sys/slist.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// LED合成器：统一管理本shield的全部LED输出，
+// 各功能只提交带优先级的图层，由合成器按帧合成并只推送变化的通道
+
+// 合成器拥有的物理输出
+enum led_comp_output {
+    LED_COMP_OUTPUT_PWM = 0,    // pwm0 通道0（背光/充电呼吸灯）
+    LED_COMP_OUTPUT_BT,         // 蓝牙状态指示GPIO
+    LED_COMP_OUTPUT_STRIP,      // WS2812灯链（轴灯/层指示）
+    LED_COMP_OUTPUT_LAYER,      // 独立RGB层指示灯
+    LED_COMP_OUTPUT_COUNT
+};
+
+// 图层优先级，数值大者覆盖数值小者
+enum led_comp_priority {
+    LED_COMP_PRIO_UNDERGLOW = 10,
+    LED_COMP_PRIO_BACKLIGHT = 20,
+    LED_COMP_PRIO_LAYER = 30,
+    LED_COMP_PRIO_BT = 40,
+    LED_COMP_PRIO_CHARGING = 50,
+};
+
+struct led_comp_layer;
+
+// 渲染一帧：向 px 写入 count 个像素（单色输出只有1个像素，亮度取RGB最大分量）
+typedef void (*led_comp_render_t)(struct led_comp_layer *layer, uint32_t now_ms,
+                                  struct led_rgb *px);
+
+// 硬件卸载钩子：图层成为该输出最上层时调用 hw_start，
+// 返回0表示外设已自主播放，合成器不再逐帧渲染该输出；被覆盖或隐藏时调用 hw_stop
+typedef int (*led_comp_hw_start_t)(struct led_comp_layer *layer);
+// 可选：动画图层距下一次内容变化的毫秒数，未提供时按 frame-ms 逐帧渲染
+typedef uint32_t (*led_comp_next_t)(struct led_comp_layer *layer, uint32_t now_ms);
+typedef void (*led_comp_hw_stop_t)(struct led_comp_layer *layer);
+
+struct led_comp_layer {
+    enum led_comp_output output;
+    uint8_t priority;
+    uint8_t first;              // 覆盖的像素范围
+    uint8_t count;
+    bool animated;              // 需要逐帧渲染
+    led_comp_render_t render;
+    led_comp_next_t next_change;    // 可选
+    led_comp_hw_start_t hw_start;   // 可选
+    led_comp_hw_stop_t hw_stop;     // 可选
+
+    // 以下由合成器维护
+    sys_snode_t node;
+    bool visible;
+    bool hw_running;
+    bool hw_failed;             // hw_start 失败后本次显示期间改为软件渲染
+};
+
+// 显示/隐藏图层，可在任意线程上下文调用，合成在 paging 工作队列中进行
+void led_comp_layer_show(struct led_comp_layer *layer);
+void led_comp_layer_hide(struct led_comp_layer *layer);
+
+// 静态图层内容变化后请求重新合成
+void led_comp_invalidate(void);
+
+// 输出的像素数，未配置的输出返回0
+uint8_t led_comp_output_size(enum led_comp_output output);
+
+// GPIO 类输出的引脚（供硬件卸载钩子使用），其他输出返回NULL
+const struct gpio_dt_spec *led_comp_output_gpio(enum led_comp_output output);
+
+// 统计：已合成的帧数、实际推送到硬件的次数
+uint32_t led_comp_get_frame_count(void);
+uint32_t led_comp_get_push_count(void);
+
+#ifdef __cplusplus
+}
+#endif
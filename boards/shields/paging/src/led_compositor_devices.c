@@ -0,0 +1,171 @@
+// 合成器的虚拟LED设备：作为 chosen zmk,backlight / zmk,underglow 提供给ZMK，
+// 把背光亮度和轴灯像素转成合成器图层，不再直接写物理输出
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/led.h>
+#include <zephyr/drivers/led_strip.h>
+#include <zephyr/logging/log.h>
+
+#include "led_compositor.h"
+
+LOG_MODULE_DECLARE(led_compositor, CONFIG_ZMK_LOG_LEVEL);
+
+/* ===================== 虚拟背光（LED API） ===================== */
+#define DT_DRV_COMPAT zmk_led_compositor_backlight
+
+struct comp_backlight_data {
+    struct led_comp_layer layer;
+    uint8_t level;
+};
+
+static void comp_backlight_render(struct led_comp_layer *layer, uint32_t now_ms,
+                                  struct led_rgb *px)
+{
+    struct comp_backlight_data *data =
+        CONTAINER_OF(layer, struct comp_backlight_data, layer);
+
+    ARG_UNUSED(now_ms);
+    px[0] = (struct led_rgb){ .r = data->level, .g = data->level, .b = data->level };
+}
+
+// ZMK 背光亮度范围 0-100
+static int comp_backlight_set_brightness(const struct device *dev, uint32_t led, uint8_t value)
+{
+    struct comp_backlight_data *data = dev->data;
+
+    ARG_UNUSED(led);
+    if (value > 100) {
+        return -EINVAL;
+    }
+
+    data->level = (uint8_t)((value * 255U) / 100U);
+    if (value > 0) {
+        // 已显示时也会触发重新合成
+        led_comp_layer_show(&data->layer);
+    } else {
+        led_comp_layer_hide(&data->layer);
+    }
+
+    return 0;
+}
+
+static int comp_backlight_on(const struct device *dev, uint32_t led)
+{
+    return comp_backlight_set_brightness(dev, led, 100);
+}
+
+static int comp_backlight_off(const struct device *dev, uint32_t led)
+{
+    return comp_backlight_set_brightness(dev, led, 0);
+}
+
+static const struct led_driver_api comp_backlight_api = {
+    .set_brightness = comp_backlight_set_brightness,
+    .on = comp_backlight_on,
+    .off = comp_backlight_off,
+};
+
+static int comp_backlight_init(const struct device *dev)
+{
+    struct comp_backlight_data *data = dev->data;
+
+    data->layer = (struct led_comp_layer){
+        .output = LED_COMP_OUTPUT_PWM,
+        .priority = LED_COMP_PRIO_BACKLIGHT,
+        .count = 1,
+        .render = comp_backlight_render,
+    };
+
+    return 0;
+}
+
+#define COMP_BACKLIGHT_DEFINE(inst)                                                     \
+    static struct comp_backlight_data comp_backlight_data_##inst;                       \
+    DEVICE_DT_INST_DEFINE(inst, comp_backlight_init, NULL, &comp_backlight_data_##inst, \
+                          NULL, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,        \
+                          &comp_backlight_api);
+
+DT_INST_FOREACH_STATUS_OKAY(COMP_BACKLIGHT_DEFINE)
+
+/* ===================== 虚拟灯链（LED strip API） ===================== */
+#undef DT_DRV_COMPAT
+#define DT_DRV_COMPAT zmk_led_compositor_strip
+
+struct comp_strip_config {
+    uint8_t length;
+};
+
+struct comp_strip_data {
+    struct led_comp_layer layer;
+    struct k_spinlock lock;
+    struct led_rgb *pixels;
+};
+
+static void comp_strip_render(struct led_comp_layer *layer, uint32_t now_ms,
+                              struct led_rgb *px)
+{
+    struct comp_strip_data *data = CONTAINER_OF(layer, struct comp_strip_data, layer);
+
+    ARG_UNUSED(now_ms);
+    K_SPINLOCK(&data->lock) {
+        memcpy(px, data->pixels, layer->count * sizeof(struct led_rgb));
+    }
+}
+
+static int comp_strip_update_rgb(const struct device *dev, struct led_rgb *pixels,
+                                 size_t num_pixels)
+{
+    const struct comp_strip_config *cfg = dev->config;
+    struct comp_strip_data *data = dev->data;
+    size_t count = MIN(num_pixels, cfg->length);
+
+    K_SPINLOCK(&data->lock) {
+        memcpy(data->pixels, pixels, count * sizeof(struct led_rgb));
+    }
+
+    led_comp_layer_show(&data->layer);
+    return 0;
+}
+
+static int comp_strip_update_channels(const struct device *dev, uint8_t *channels,
+                                      size_t num_channels)
+{
+    return -ENOTSUP;
+}
+
+static const struct led_strip_driver_api comp_strip_api = {
+    .update_rgb = comp_strip_update_rgb,
+    .update_channels = comp_strip_update_channels,
+};
+
+static int comp_strip_init(const struct device *dev)
+{
+    const struct comp_strip_config *cfg = dev->config;
+    struct comp_strip_data *data = dev->data;
+
+    data->layer = (struct led_comp_layer){
+        .output = LED_COMP_OUTPUT_STRIP,
+        .priority = LED_COMP_PRIO_UNDERGLOW,
+        .count = cfg->length,
+        .render = comp_strip_render,
+    };
+
+    return 0;
+}
+
+#define COMP_STRIP_DEFINE(inst)                                                          \
+    static struct led_rgb comp_strip_pixels_##inst[DT_INST_PROP(inst, chain_length)];    \
+    static struct comp_strip_data comp_strip_data_##inst = {                             \
+        .pixels = comp_strip_pixels_##inst,                                              \
+    };                                                                                   \
+    static const struct comp_strip_config comp_strip_config_##inst = {                   \
+        .length = DT_INST_PROP(inst, chain_length),                                      \
+    };                                                                                   \
+    DEVICE_DT_INST_DEFINE(inst, comp_strip_init, NULL, &comp_strip_data_##inst,          \
+                          &comp_strip_config_##inst, POST_KERNEL,                        \
+                          CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &comp_strip_api);
+
+DT_INST_FOREACH_STATUS_OKAY(COMP_STRIP_DEFINE)
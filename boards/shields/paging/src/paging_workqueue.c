@@ -0,0 +1,105 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/init.h>
+
+LOG_MODULE_REGISTER(paging_workqueue, CONFIG_ZMK_LOG_LEVEL);
+
+#include "paging_workqueue.h"
+
+#if IS_ENABLED(CONFIG_ZMK_PAGING_WORKQUEUE)
+
+// 独立工作队列：可抢占的低优先级线程，PWM步进、I2C刷新等不会阻塞
+// 系统工作队列上的按键/HID处理
+K_THREAD_STACK_DEFINE(paging_work_q_stack, CONFIG_ZMK_PAGING_WORKQUEUE_STACK_SIZE);
+static struct k_work_q paging_work_q_inst;
+
+struct k_work_q *paging_work_q(void)
+{
+    return &paging_work_q_inst;
+}
+
+static int paging_workqueue_init(void)
+{
+    const struct k_work_queue_config cfg = {
+        .name = "paging_wq",
+    };
+
+    k_work_queue_start(&paging_work_q_inst, paging_work_q_stack,
+                       K_THREAD_STACK_SIZEOF(paging_work_q_stack),
+                       CONFIG_ZMK_PAGING_WORKQUEUE_PRIORITY, &cfg);
+
+    LOG_INF("Paging workqueue started (priority %d)", CONFIG_ZMK_PAGING_WORKQUEUE_PRIORITY);
+    return 0;
+}
+
+// 必须早于POST_KERNEL阶段的paging驱动初始化
+SYS_INIT(paging_workqueue_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#else
+
+struct k_work_q *paging_work_q(void)
+{
+    return &k_sys_work_q;
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_PAGING_WORKQUEUE) */
+
+#if IS_ENABLED(CONFIG_ZMK_PAGING_WORKQUEUE_LATENCY_PROBE)
+
+// 系统工作队列延迟探针：定时从中断上下文向系统工作队列提交探测工作，
+// 记录从提交到执行的时间。按键映射/HID工作同在系统工作队列上，
+// 该延迟即为它们被其他工作阻塞的时间。分别在启用和关闭
+// CONFIG_ZMK_PAGING_WORKQUEUE 时运行，对比日志中的最坏值。
+static struct k_timer probe_timer;
+static struct k_work probe_work;
+static uint32_t probe_submit_cycles;
+static uint32_t probe_max_us;
+static uint64_t probe_total_us;
+static uint32_t probe_samples;
+
+static void probe_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    uint32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - probe_submit_cycles);
+
+    probe_samples++;
+    probe_total_us += latency_us;
+    if (latency_us > probe_max_us) {
+        probe_max_us = latency_us;
+    }
+
+    if (probe_samples * CONFIG_ZMK_PAGING_WORKQUEUE_LATENCY_PROBE_INTERVAL_MS >=
+        CONFIG_ZMK_PAGING_WORKQUEUE_LATENCY_PROBE_REPORT_MS) {
+        LOG_INF("sys workqueue latency (paging wq %s): max %u us, avg %u us, %u samples",
+                IS_ENABLED(CONFIG_ZMK_PAGING_WORKQUEUE) ? "on" : "off", probe_max_us,
+                (uint32_t)(probe_total_us / probe_samples), probe_samples);
+        probe_samples = 0;
+        probe_total_us = 0;
+        probe_max_us = 0;
+    }
+}
+
+static void probe_timer_handler(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    // 上一次探测尚未执行时不覆盖时间戳，保留最坏情况
+    if (!k_work_is_pending(&probe_work)) {
+        probe_submit_cycles = k_cycle_get_32();
+        k_work_submit(&probe_work);
+    }
+}
+
+static int paging_latency_probe_init(void)
+{
+    k_work_init(&probe_work, probe_work_handler);
+    k_timer_init(&probe_timer, probe_timer_handler, NULL);
+    k_timer_start(&probe_timer, K_MSEC(CONFIG_ZMK_PAGING_WORKQUEUE_LATENCY_PROBE_INTERVAL_MS),
+                  K_MSEC(CONFIG_ZMK_PAGING_WORKQUEUE_LATENCY_PROBE_INTERVAL_MS));
+    return 0;
+}
+
+SYS_INIT(paging_latency_probe_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif /* IS_ENABLED(CONFIG_ZMK_PAGING_WORKQUEUE_LATENCY_PROBE) */
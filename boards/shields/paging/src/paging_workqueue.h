@@ -0,0 +1,16 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// paging扩展驱动（充电、背光、状态灯、显示等）统一提交工作的队列。
+// 启用 CONFIG_ZMK_PAGING_WORKQUEUE 时为低优先级的独立队列，
+// 否则退回系统工作队列。
+struct k_work_q *paging_work_q(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,104 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+
+#include <zmk/display/status_screen.h>
+#include <zmk/display/widgets/output_status.h>
+#include <zmk/display/widgets/battery_status.h>
+#include <zmk/display/widgets/layer_status.h>
+#include <zmk/display/widgets/wpm_status.h>
+
+#if IS_ENABLED(CONFIG_ZMK_PAGING_DISPLAY_COALESCE)
+#include "display_refresh.h"
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_PAGING_CHARGING_WIDGET)
+#include "charging_widget.h"
+#endif
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// 自定义状态屏：布局与 ZMK 内置状态屏相同（左上输出、右上电量、左下层、右下 WPM），
+// 各控件重绘的区域经 oled_shadow 比较后只发送实际变化的列
+#if IS_ENABLED(CONFIG_ZMK_WIDGET_BATTERY_STATUS)
+static struct zmk_widget_battery_status battery_status_widget;
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_WIDGET_OUTPUT_STATUS)
+static struct zmk_widget_output_status output_status_widget;
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_WIDGET_LAYER_STATUS)
+static struct zmk_widget_layer_status layer_status_widget;
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_WIDGET_WPM_STATUS)
+static struct zmk_widget_wpm_status wpm_status_widget;
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_PAGING_CHARGING_WIDGET)
+static struct charging_widget charging_widget;
+
+#if IS_ENABLED(CONFIG_ZMK_WIDGET_BATTERY_STATUS)
+// 电量标签宽度随内容变化（USB 供电时前面多一个充电符号），每次尺寸变化后
+// 按新宽度重新放到它的左侧，避免与之重叠
+static void place_charging_widget(lv_obj_t *battery)
+{
+    lv_obj_align(charging_widget_obj(&charging_widget), LV_ALIGN_TOP_RIGHT,
+                 -lv_obj_get_width(battery), 0);
+}
+
+static void battery_size_changed_cb(lv_event_t *e)
+{
+    place_charging_widget(lv_event_get_target(e));
+}
+#endif
+#endif
+
+lv_obj_t *zmk_display_status_screen(void)
+{
+    lv_obj_t *screen = lv_obj_create(NULL);
+
+#if IS_ENABLED(CONFIG_ZMK_WIDGET_BATTERY_STATUS)
+    zmk_widget_battery_status_init(&battery_status_widget, screen);
+    lv_obj_align(zmk_widget_battery_status_obj(&battery_status_widget), LV_ALIGN_TOP_RIGHT, 0,
+                 0);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_WIDGET_OUTPUT_STATUS)
+    zmk_widget_output_status_init(&output_status_widget, screen);
+    lv_obj_align(zmk_widget_output_status_obj(&output_status_widget), LV_ALIGN_TOP_LEFT, 0, 0);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_WIDGET_LAYER_STATUS)
+    zmk_widget_layer_status_init(&layer_status_widget, screen);
+    lv_obj_set_style_text_font(zmk_widget_layer_status_obj(&layer_status_widget),
+                               lv_theme_get_font_small(screen), LV_PART_MAIN);
+    lv_obj_align(zmk_widget_layer_status_obj(&layer_status_widget), LV_ALIGN_BOTTOM_LEFT, 0, 0);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_WIDGET_WPM_STATUS)
+    zmk_widget_wpm_status_init(&wpm_status_widget, screen);
+    lv_obj_align(zmk_widget_wpm_status_obj(&wpm_status_widget), LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_PAGING_CHARGING_WIDGET)
+    // 充电图标放在电量控件左侧
+    charging_widget_init(&charging_widget, screen);
+#if IS_ENABLED(CONFIG_ZMK_WIDGET_BATTERY_STATUS)
+    lv_obj_t *battery = zmk_widget_battery_status_obj(&battery_status_widget);
+
+    lv_obj_add_event_cb(battery, battery_size_changed_cb, LV_EVENT_SIZE_CHANGED, NULL);
+    lv_obj_update_layout(battery);
+    place_charging_widget(battery);
+#else
+    lv_obj_align(charging_widget_obj(&charging_widget), LV_ALIGN_TOP_RIGHT, 0, 0);
+#endif
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_PAGING_DISPLAY_COALESCE)
+    display_refresh_init();
+#endif
+
+    return screen;
+}